@@ -0,0 +1,108 @@
+#include "AtmosphereModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace {
+//     : ,    
+double interpolateDensity(const std::vector<double>& altitudes, const std::vector<double>& densities, double altitude) {
+    const size_t upper = static_cast<size_t>(std::upper_bound(altitudes.begin(), altitudes.end(), altitude) - altitudes.begin());
+    if (upper == 0) return densities.front();
+    if (upper == altitudes.size()) return densities.back();
+    const size_t lower = upper - 1;
+    const double t = (altitude - altitudes[lower]) / (altitudes[upper] - altitudes[lower]);
+    if (densities[lower] > 0.0 && densities[upper] > 0.0) {
+        return densities[lower] * std::pow(densities[upper] / densities[lower], t);
+    }
+    return densities[lower] + (densities[upper] - densities[lower]) * t;
+}
+
+// FNV-1a  
+uint64_t hashValues(const std::vector<double>& values, uint64_t hash) {
+    for (double value : values) {
+        unsigned char bytes[sizeof(double)];
+        std::memcpy(bytes, &value, sizeof(double));
+        for (unsigned char byte : bytes) {
+            hash ^= byte;
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+}
+
+constexpr int AtmosphereModel::RESAMPLED_CELLS;
+
+AtmosphereModel::AtmosphereModel(const std::vector<double>& altitudes, const std::vector<double>& densities)
+    : m_cells(RESAMPLED_CELLS + 1) {
+    m_minAltitude = altitudes.front();
+    const double cellWidth = (altitudes.back() - altitudes.front()) / RESAMPLED_CELLS;
+    m_inverseCellWidth = 1.0 / cellWidth;
+    m_maxAltitude = altitudes.back();
+    for (int i = 0; i < RESAMPLED_CELLS; ++i) {
+        const double low = m_minAltitude + cellWidth * i;
+        const double lowDensity = interpolateDensity(altitudes, densities, low);
+        const double highDensity = interpolateDensity(altitudes, densities, low + cellWidth);
+        m_cells[i] = { low, lowDensity, (highDensity - lowDensity) / cellWidth };
+    }
+    m_cells[RESAMPLED_CELLS] = { altitudes.back(), densities.back(), 0.0 };
+
+    // 53   -      double
+    m_fingerprint = static_cast<double>(hashValues(densities, hashValues(altitudes, 14695981039346656037ull)) >> 11);
+}
+
+std::shared_ptr<AtmosphereModel> AtmosphereModel::loadTable(const std::string& path) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        std::cerr << "AtmosphereModel:    " << path << "\n";
+        return nullptr;
+    }
+    std::vector<double> altitudes, densities;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        std::istringstream fields(line);
+        double altitude, density;
+        if (!(fields >> altitude)) continue; //  
+        if (!(fields >> density) || density < 0.0 || (!altitudes.empty() && altitude <= altitudes.back())) {
+            std::cerr << "AtmosphereModel: " << path << ",  " << lineNumber
+                << ":   ( )   \n";
+            return nullptr;
+        }
+        altitudes.push_back(altitude);
+        densities.push_back(density);
+    }
+    if (altitudes.size() < 2) {
+        std::cerr << "AtmosphereModel:  " << path << "    \n";
+        return nullptr;
+    }
+    return std::shared_ptr<AtmosphereModel>(new AtmosphereModel(altitudes, densities));
+}
+
+std::shared_ptr<AtmosphereModel> AtmosphereModel::exponential(double surfaceDensity, double scaleHeight, double maxAltitude) {
+    //    ,  NaN   
+    if (!(scaleHeight > 0.0) || !(maxAltitude > 0.0) || !(surfaceDensity >= 0.0) ||
+        !std::isfinite(maxAltitude) || !std::isfinite(surfaceDensity)) {
+        std::cerr << "AtmosphereModel:  scaleHeight > 0, 0 < maxAltitude < inf   >= 0\n";
+        return nullptr;
+    }
+    //      :      .
+    //  ,   ,   -      RESAMPLED_CELLS 
+    const double nodesWanted = std::ceil(4.0 * maxAltitude / scaleHeight) + 1.0;
+    const int nodes = static_cast<int>(std::max(2.0, std::min(nodesWanted, 4.0 * RESAMPLED_CELLS + 1.0)));
+    std::vector<double> altitudes(nodes), densities(nodes);
+    for (int i = 0; i < nodes; ++i) {
+        altitudes[i] = maxAltitude * i / (nodes - 1);
+        densities[i] = surfaceDensity * std::exp(-altitudes[i] / scaleHeight);
+    }
+    densities.back() = 0.0; //  maxAltitude  
+    return std::shared_ptr<AtmosphereModel>(new AtmosphereModel(altitudes, densities));
+}
@@ -0,0 +1,70 @@
+#ifndef ATMOSPHEREMODEL_H
+#define ATMOSPHEREMODEL_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+//          (h = r - CENTRAL_BODY_RADIUS,
+//     ,   ).
+//
+//   (  )     
+//   RESAMPLED_CELLS :      
+//  (   ),      
+//   .     -  ,  
+//  min/max    ,     exp.
+//      ,  - .
+class AtmosphereModel {
+public:
+    //  :  " "   , '#' - .
+    // nullptr (   std::cerr),       .
+    static std::shared_ptr<AtmosphereModel> loadTable(const std::string& path);
+    // rho(h) = surfaceDensity * exp(-h / scaleHeight)  [0, maxAltitude],  - 0.
+    // nullptr ( ),  scaleHeight  maxAltitude     < 0.
+    static std::shared_ptr<AtmosphereModel> exponential(double surfaceDensity, double scaleHeight, double maxAltitude);
+
+    double density(double altitude) const {
+        const double clamped = clampAltitude(altitude);
+        const Cell& cell = m_cells[static_cast<size_t>((clamped - m_minAltitude) * m_inverseCellWidth)];
+        return cell.value + cell.slope * (clamped - cell.altitude);
+    }
+
+    //       (   )
+    double density(double altitude, double& derivative) const {
+        const double clamped = clampAltitude(altitude);
+        const Cell& cell = m_cells[static_cast<size_t>((clamped - m_minAltitude) * m_inverseCellWidth)];
+        derivative = clamped == altitude ? cell.slope : 0.0;
+        return cell.value + cell.slope * (clamped - cell.altitude);
+    }
+
+    //     SimulationCache:   -  
+    double fingerprint() const { return m_fingerprint; }
+
+private:
+    static constexpr int RESAMPLED_CELLS = 8192;
+
+    //  : rho(h) = value + slope * (h - altitude)  h  
+    struct Cell {
+        double altitude;
+        double value;
+        double slope;
+    };
+
+    AtmosphereModel(const std::vector<double>& altitudes, const std::vector<double>& densities);
+
+    //    ;     min/max  .
+    //    ,  NaN (   )   ,
+    //      static_cast<size_t>(NaN).
+    double clampAltitude(double altitude) const {
+        altitude = altitude > m_minAltitude ? altitude : m_minAltitude;
+        return altitude > m_maxAltitude ? m_maxAltitude : altitude;
+    }
+
+    std::vector<Cell> m_cells;  // RESAMPLED_CELLS + 1:  -   
+    double m_minAltitude;
+    double m_maxAltitude;
+    double m_inverseCellWidth;
+    double m_fingerprint;
+};
+
+#endif // ATMOSPHEREMODEL_H
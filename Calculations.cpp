@@ -1,93 +1,254 @@
 #include "Calculations.h"
+#include "IntegratorCore.h"
+#include "OrbitAnalytics.h"
+#include "KeplerPropagator.h"
 
-Calculations::Calculations() {
-    //    ,    
+#include <algorithm>
+
+Calculations::Calculations()
+    : m_derivativeEvaluations(0),
+    m_verbose(true) {
 }
 
 //     
 std::vector<State> Calculations::runSimulation(const SimulationParameters& params) {
+    std::vector<State> trajectoryStates;
+    runSimulation(params, trajectoryStates);
+    return trajectoryStates;
+}
+
+//       
+void Calculations::runSimulation(const SimulationParameters& params, std::vector<State>& trajectoryStates,
+    OrbitAnalytics* analytics, StateSensitivity* sensitivity) {
     State currentState;
     currentState.x = params.initialState.x;
     currentState.y = params.initialState.y;
     currentState.vx = params.initialState.vx;
     currentState.vy = params.initialState.vy;
 
-    std::vector<State> trajectoryStates; //    
-    trajectoryStates.reserve(static_cast<size_t>(params.STEPS) + 1);
+    m_derivativeEvaluations = 0;
+    trajectoryStates.clear(); //    .      
+    trajectoryStates.reserve(static_cast<size_t>(params.STEPS) + 1); //  ,     
     trajectoryStates.push_back(currentState); //   
+    if (analytics) {
+        analytics->reset(params);
+        analytics->addState(currentState);
+    }
+    if (sensitivity) sensitivity->reset();
 
     double initial_r_squared = currentState.x * currentState.x + currentState.y * currentState.y;
     if (initial_r_squared < params.CENTRAL_BODY_RADIUS * params.CENTRAL_BODY_RADIUS) {
-        std::cout << ":   (" << currentState.x << ", " << currentState.y
+        if (m_verbose) std::cout << ":   (" << currentState.x << ", " << currentState.y
             << ")     (" << params.CENTRAL_BODY_RADIUS << ").\n";
-        return trajectoryStates;
+        return;
+    }
+
+    continueSimulation(params, 0, params.STEPS, trajectoryStates, analytics, sensitivity);
+}
+
+//     Scalar.     Scalar  ,
+//  sink      double.
+namespace {
+//       DT:     r -> 0
+const int MAX_SUNDMAN_SUBSTEPS = 1000000;
+
+template <typename Scalar, bool Compensated>
+inline void applyIncrement(BasicState<Scalar>& state, const BasicState<Scalar>& increment,
+    BasicState<Scalar>& compensation) {
+    if (Compensated) {
+        compensatedAdd(state.x, increment.x, compensation.x);
+        compensatedAdd(state.y, increment.y, compensation.y);
+        compensatedAdd(state.vx, increment.vx, compensation.vx);
+        compensatedAdd(state.vy, increment.vy, compensation.vy);
+    }
+    else {
+        state = { state.x + increment.x, state.y + increment.y, state.vx + increment.vx, state.vy + increment.vy };
     }
+}
 
-    for (int i = 0; i < params.STEPS; ++i) {
-        currentState = rungeKuttaStep(currentState, params.DT, params); //  params 
+template <typename Scalar, bool Compensated>
+bool integrateSteps(const SimulationParameters& params, const State& start, int firstStep, int lastStep,
+    StateSink& sink, OrbitAnalytics* analytics, long long& evaluations, bool verbose) {
+    typedef BasicState<Scalar> ScalarState;
+    const IntegratorCore<Scalar> core(params);
+    const Scalar dt = static_cast<Scalar>(params.DT);
+    const Scalar sundmanStep = static_cast<Scalar>(params.SUNDMAN_STEP);
+    const bool regularized = params.SUNDMAN_STEP > 0.0;
 
-        trajectoryStates.push_back(currentState); //   
+    ScalarState currentState = {
+        static_cast<Scalar>(start.x), static_cast<Scalar>(start.y),
+        static_cast<Scalar>(start.vx), static_cast<Scalar>(start.vy)
+    };
+    ScalarState compensation = { 0, 0, 0, 0 }; //    Compensated
 
-        double r_squared = currentState.x * currentState.x + currentState.y * currentState.y;
-        if (r_squared < params.CENTRAL_BODY_RADIUS * params.CENTRAL_BODY_RADIUS) {
-            std::cout << "    " << i + 1
-                << "  . : (" << currentState.x << ", " << currentState.y
-                << "), r = " << std::sqrt(r_squared) << "\n";
+    for (int i = firstStep; i < lastStep; ++i) {
+        Scalar remaining = dt;
+        if (regularized) {
+            //    ,      ; 
+            // (  r * SUNDMAN_STEP) -   4,     .
+            //      ,   
+            //    ,     .
+            for (int substep = 0; substep < MAX_SUNDMAN_SUBSTEPS; ++substep) {
+                if (remaining <= core.radius(currentState) * sundmanStep || core.isInsideCentralBody(currentState)) break;
+                Scalar timeIncrement;
+                ScalarState increment = core.sundmanIncrement(currentState, sundmanStep, timeIncrement);
+                evaluations += 4;
+                if (timeIncrement >= remaining) break;
+                applyIncrement<Scalar, Compensated>(currentState, increment, compensation);
+                remaining -= timeIncrement;
+            }
+        }
+        applyIncrement<Scalar, Compensated>(currentState, core.rungeKuttaIncrement(currentState, remaining), compensation);
+        evaluations += 4;
+
+        const State stored = { //   
+            static_cast<double>(currentState.x), static_cast<double>(currentState.y),
+            static_cast<double>(currentState.vx), static_cast<double>(currentState.vy) };
+        sink.push(stored);
+        if (analytics) analytics->addState(stored);
+
+        if (core.isInsideCentralBody(currentState)) {
+            if (verbose) std::cout << "    " << i + 1
+                << "  . : (" << stored.x << ", " << stored.y
+                << "), r = " << std::sqrt(stored.x * stored.x + stored.y * stored.y) << "\n";
+            return true;
+        }
+    }
+    return false;
+}
+
+// 4  double     .     ,
+//    integrateSteps<double, false>,       .
+bool integrateStepsWithSensitivity(const SimulationParameters& params, int firstStep, int lastStep,
+    std::vector<State>& trajectoryStates, OrbitAnalytics* analytics, StateSensitivity& sensitivity,
+    long long& evaluations, bool verbose) {
+    typedef IntegratorCore<double> Core;
+    const Core core(params);
+
+    double v[Core::VARIATIONAL_SIZE];
+    const State& last = trajectoryStates.back();
+    v[0] = last.x;
+    v[1] = last.y;
+    v[2] = last.vx;
+    v[3] = last.vy;
+    std::copy(&sensitivity.stateTransition[0][0], &sensitivity.stateTransition[0][0] + 16, v + Core::PHI_OFFSET);
+    std::copy(sensitivity.propulsion, sensitivity.propulsion + 4, v + Core::PROPULSION_OFFSET);
+
+    bool collided = false;
+    for (int i = firstStep; i < lastStep; ++i) {
+        core.variationalStep(v, params.DT);
+        evaluations += 4;
+
+        trajectoryStates.push_back({ v[0], v[1], v[2], v[3] });
+        if (analytics) analytics->addState(trajectoryStates.back());
+
+        if (core.isInsideCentralBody(trajectoryStates.back())) {
+            const State& stored = trajectoryStates.back();
+            if (verbose) std::cout << "    " << i + 1
+                << "  . : (" << stored.x << ", " << stored.y
+                << "), r = " << std::sqrt(stored.x * stored.x + stored.y * stored.y) << "\n";
+            collided = true;
             break;
         }
     }
-    return trajectoryStates;
+    std::copy(v + Core::PHI_OFFSET, v + Core::PHI_OFFSET + 16, &sensitivity.stateTransition[0][0]);
+    std::copy(v + Core::PROPULSION_OFFSET, v + Core::PROPULSION_OFFSET + 4, sensitivity.propulsion);
+    return collided;
+}
 }
 
-//     
-State Calculations::derivatives(const State& s, const SimulationParameters& params) {
-    double r_squared = s.x * s.x + s.y * s.y;
-    if (r_squared == 0) {
-        return { s.vx, s.vy, 0, 0 };
+void StateSensitivity::reset() {
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            stateTransition[row][column] = row == column ? 1.0 : 0.0;
+        }
+        propulsion[row] = 0.0;
     }
-    double r = std::sqrt(r_squared);
-    double r_cubed = r_squared * r;
+}
+
+double StateSensitivity::radiusCrossingTimeDerivative(const State& state, const double stateDerivative[4]) {
+    // r(t + dt, p + dp) = r: (r . dr/dp) dp + (r . v) dt = 0
+    const double radialVelocity = state.x * state.vx + state.y * state.vy;
+    if (radialVelocity == 0.0) return 0.0;
+    return -(state.x * stateDerivative[0] + state.y * stateDerivative[1]) / radialVelocity;
+}
 
-    double common_factor_gravity = -params.G * params.M / r_cubed;
-    double net_propulsion_factor = params.THRUST_COEFFICIENT - params.DRAG_COEFFICIENT;
+//      
+bool Calculations::continueSimulation(const SimulationParameters& params, int firstStep, int lastStep,
+    std::vector<State>& trajectoryStates, OrbitAnalytics* analytics, StateSensitivity* sensitivity) {
+    if (trajectoryStates.empty()) return false;
+    trajectoryStates.reserve(static_cast<size_t>(lastStep) + 1);
 
-    double ax = common_factor_gravity * s.x + net_propulsion_factor * s.vx;
-    double ay = common_factor_gravity * s.y + net_propulsion_factor * s.vy;
-    return { s.vx, s.vy, ax, ay };
+    //       4     double
+    if (sensitivity) {
+        if (m_verbose && (params.PRECISION != Precision::Double || params.SUNDMAN_STEP > 0.0 ||
+            KeplerPropagator::isApplicable(params))) {
+            std::cout << "Calculations:   4  double   DT "
+                "(,      )\n";
+        }
+        return integrateStepsWithSensitivity(params, firstStep, lastStep, trajectoryStates, analytics, *sensitivity,
+            m_derivativeEvaluations, m_verbose);
+    }
+
+    const State start = trajectoryStates.back();
+    StateSink sink(trajectoryStates);
+    return integrate(params, start, firstStep, lastStep, sink, analytics);
 }
 
-//     - 4- 
-State Calculations::rungeKuttaStep(const State& s, double dt, const SimulationParameters& params) {
-    State k1 = derivatives(s, params);
+bool Calculations::continueSimulation(const SimulationParameters& params, const State& start, int firstStep,
+    int lastStep, State* output, size_t& produced, OrbitAnalytics* analytics) {
+    StateSink sink(output);
+    const bool collided = integrate(params, start, firstStep, lastStep, sink, analytics);
+    produced = sink.count();
+    return collided;
+}
 
-    State s_temp_k2 = {
-        s.x + dt * k1.x / 2.0,
-        s.y + dt * k1.y / 2.0,
-        s.vx + dt * k1.vx / 2.0,
-        s.vy + dt * k1.vy / 2.0
-    };
-    State k2 = derivatives(s_temp_k2, params);
+bool Calculations::integrate(const SimulationParameters& params, const State& start, int firstStep, int lastStep,
+    StateSink& sink, OrbitAnalytics* analytics) {
+    //        :   ,   
+    // ( Scalar     -    double)
+    if (KeplerPropagator::isApplicable(params)) {
+        bool collided = false;
+        if (KeplerPropagator::propagate(params, start, firstStep, lastStep, sink, analytics, collided, m_verbose)) {
+            return collided;
+        }
+    }
 
-    State s_temp_k3 = {
-        s.x + dt * k2.x / 2.0,
-        s.y + dt * k2.y / 2.0,
-        s.vx + dt * k2.vx / 2.0,
-        s.vy + dt * k2.vy / 2.0
-    };
-    State k3 = derivatives(s_temp_k3, params);
+    switch (params.PRECISION) {
+    case Precision::Float:
+        return integrateSteps<float, false>(params, start, firstStep, lastStep, sink, analytics, m_derivativeEvaluations, m_verbose);
+    case Precision::LongDouble:
+        return integrateSteps<long double, false>(params, start, firstStep, lastStep, sink, analytics, m_derivativeEvaluations, m_verbose);
+    case Precision::Compensated:
+        return integrateSteps<double, true>(params, start, firstStep, lastStep, sink, analytics, m_derivativeEvaluations, m_verbose);
+    case Precision::Double:
+    default:
+        return integrateSteps<double, false>(params, start, firstStep, lastStep, sink, analytics, m_derivativeEvaluations, m_verbose);
+    }
+}
 
-    State s_temp_k4 = {
-        s.x + dt * k3.x,
-        s.y + dt * k3.y,
-        s.vx + dt * k3.vx,
-        s.vy + dt * k3.vy
-    };
-    State k4 = derivatives(s_temp_k4, params);
+//     - 4- 
+State Calculations::rungeKuttaStep(const State& s, double dt, const SimulationParameters& params) {
+    return IntegratorCore<double>(params).rungeKuttaStep(s, dt);
+}
 
-    return {
-        s.x + dt / 6.0 * (k1.x + 2.0 * k2.x + 2.0 * k3.x + k4.x),
-        s.y + dt / 6.0 * (k1.y + 2.0 * k2.y + 2.0 * k3.y + k4.y),
-        s.vx + dt / 6.0 * (k1.vx + 2.0 * k2.vx + 2.0 * k3.vx + k4.vx),
-        s.vy + dt / 6.0 * (k1.vy + 2.0 * k2.vy + 2.0 * k3.vy + k4.vy)
-    };
-}
\ No newline at end of file
+const char* Calculations::precisionName(Precision precision) {
+    switch (precision) {
+    case Precision::Float: return "float";
+    case Precision::LongDouble: return "long-double";
+    case Precision::Compensated: return "kahan";
+    case Precision::Double:
+    default: return "double";
+    }
+}
+
+bool Calculations::parsePrecision(const std::string& name, Precision& precision) {
+    const Precision all[] = { Precision::Float, Precision::Double, Precision::LongDouble, Precision::Compensated };
+    for (Precision candidate : all) {
+        if (name == precisionName(candidate)) {
+            precision = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -3,9 +3,21 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 #include <cmath>    //  std::sqrt
 #include <iostream> //  std::cerr
 
+class AtmosphereModel;
+
+//   ,    .
+//       State (double).
+enum class Precision {
+    Float,       //   
+    Double,      //  
+    LongDouble,
+    Compensated  // double +      ( 1e8+ )
+};
+
 //  
 struct SimulationParameters {
     double G = 1.0;
@@ -15,6 +27,19 @@ struct SimulationParameters {
     double THRUST_COEFFICIENT = 0.00;
     double DT = 0.001;
     int STEPS = 100000;
+    Precision PRECISION = Precision::Double;
+    //           (KeplerPropagator),
+    //   ; PRECISION  SUNDMAN_STEP   . false -  4
+    // (,         4-).
+    bool ANALYTIC_KEPLER = true;
+    //  :   DT      s
+    // (dt = r ds)   SUNDMAN_STEP,      r   
+    //   . DT   . 0 -  (  4  DT).
+    double SUNDMAN_STEP = 0.0;
+    //   : a = -ATMOSPHERE_DRAG * rho(h) * |v| * v,  rho - 
+    //  ATMOSPHERE   h = r - CENTRAL_BODY_RADIUS.    DRAG_COEFFICIENT.
+    double ATMOSPHERE_DRAG = 0.0;
+    std::shared_ptr<const AtmosphereModel> ATMOSPHERE;
 
     struct InitialStateParams {
         double x = 1.5;
@@ -24,24 +49,112 @@ struct SimulationParameters {
     } initialState;
 };
 
-//  
-struct State {
-    double x, y, vx, vy;
+//  .   (IntegratorCore)   BasicState  ,
+//   -  State   .
+template <typename Scalar>
+struct BasicState {
+    Scalar x, y, vx, vy;
+};
+typedef BasicState<double> State;
+
+//         .
+//    x, y, vx, vy.    F  k   F - k,
+//  d state / dF = propulsion, d state / dk = -propulsion.
+// V0  -   vy: d state / dV0 =  3 stateTransition.
+struct StateSensitivity {
+    double stateTransition[4][4]; // d state(t) / d state(0)
+    double propulsion[4];         // d state(t) / d(F - k)
+
+    //  : Phi = I, P = 0
+    void reset();
+
+    //  ,       state (,
+    //     ),     .
+    // stateDerivative - d state / d  ( stateTransition  propulsion).
+    static double radiusCrossingTimeDerivative(const State& state, const double stateDerivative[4]);
+};
+
+//     :        
+// (        -    )
+class StateSink {
+public:
+    explicit StateSink(std::vector<State>& states) : m_states(&states), m_buffer(nullptr), m_count(0) {}
+    explicit StateSink(State* buffer) : m_states(nullptr), m_buffer(buffer), m_count(0) {}
+
+    void push(const State& state) {
+        if (m_states) m_states->push_back(state);
+        else m_buffer[m_count] = state;
+        ++m_count;
+    }
+    size_t count() const { return m_count; } //      
+
+private:
+    std::vector<State>* m_states;
+    State* m_buffer;
+    size_t m_count;
 };
 
+class OrbitAnalytics;
+
 class Calculations {
 public:
     Calculations(); //   
 
+    //   .    ,    :
+    //  ,   ,     SimulationCache.
+    static constexpr int INTEGRATOR_VERSION = 2;
+
     //     
     std::vector<State> runSimulation(const SimulationParameters& params);
 
-private:
-    //     
-    static State derivatives(const State& s, const SimulationParameters& params);
+    //  ,      .     ,
+    //       ( )    .
+    //   analytics,           .
+    //   sensitivity,        4  
+    //   -      (   2N+1).
+    void runSimulation(const SimulationParameters& params, std::vector<State>& trajectoryStates,
+        OrbitAnalytics* analytics = nullptr, StateSensitivity* sensitivity = nullptr);
+
+    //  : trajectoryStates    0..firstStep (  -
+    //    firstStep),   firstStep+1..lastStep.
+    //  true,       .
+    // analytics ( )     0..firstStep -    ,
+    // sensitivity -   firstStep.
+    bool continueSimulation(const SimulationParameters& params, int firstStep, int lastStep,
+        std::vector<State>& trajectoryStates, OrbitAnalytics* analytics = nullptr,
+        StateSensitivity* sensitivity = nullptr);
+
+    //    :  firstStep+1..lastStep,    start ( firstStep),
+    //    output -      lastStep - firstStep .
+    // produced -   (,   ).  .
+    bool continueSimulation(const SimulationParameters& params, const State& start, int firstStep, int lastStep,
+        State* output, size_t& produced, OrbitAnalytics* analytics = nullptr);
 
-    //     - 4- 
+    //     - 4-  ( ).
+    //   PararealCalculations:     -   4   .
     static State rungeKuttaStep(const State& s, double dt, const SimulationParameters& params);
+
+    //       : float, double, long-double, kahan
+    static const char* precisionName(Precision precision);
+    static bool parsePrecision(const std::string& name, Precision& precision);
+
+    //    (IntegratorCore::derivatives    
+    //  )   runSimulation -    
+    // .      .
+    long long getDerivativeEvaluations() const { return m_derivativeEvaluations; }
+
+    // false -      std::cout (,   4  ..).
+    //  ,  stdout  - (trajectory_c).
+    void setVerbose(bool verbose) { m_verbose = verbose; }
+
+private:
+    //    continueSimulation  :    4
+    //   
+    bool integrate(const SimulationParameters& params, const State& start, int firstStep, int lastStep,
+        StateSink& sink, OrbitAnalytics* analytics);
+
+    long long m_derivativeEvaluations;
+    bool m_verbose;
 };
 
 #endif // CALCULATIONS_H
\ No newline at end of file
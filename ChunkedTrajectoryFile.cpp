@@ -0,0 +1,270 @@
+#include "ChunkedTrajectoryFile.h"
+#include "OrbitAnalytics.h"
+
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+#include <limits>
+
+namespace {
+const char CHUNKED_FILE_MAGIC[4] = { 'T', 'R', 'J', 'K' };
+const uint32_t CHUNKED_FILE_FORMAT = 1;
+
+// : magic[4], , CHUNK_POINTS, LOD_LEVELS, LOD_FACTOR (uint32),
+//  ,  ,   (uint64),    (double)
+const std::streamoff HEADER_SIZE = 4 + 4 * 4 + 3 * 8 + 8;
+
+//       writeSimulation
+const int SIMULATION_BLOCK_STEPS = 1 << 20;
+
+template <typename T>
+void writeValue(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool readValue(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+}
+
+//  static constexpr    C++17:      writeValue
+constexpr uint32_t ChunkedTrajectoryFile::CHUNK_POINTS;
+constexpr uint32_t ChunkedTrajectoryFile::LOD_LEVELS;
+constexpr uint32_t ChunkedTrajectoryFile::LOD_FACTOR;
+
+uint32_t ChunkedTrajectoryFile::levelStep(uint32_t level) {
+    uint32_t step = 1;
+    for (uint32_t i = 0; i < level; ++i) step *= LOD_FACTOR;
+    return step;
+}
+
+uint32_t ChunkedTrajectoryFile::levelPointOffset(const ChunkInfo& chunk, uint32_t level, uint32_t j) {
+    uint64_t offset = static_cast<uint64_t>(j) * levelStep(level);
+    return static_cast<uint32_t>(std::min<uint64_t>(offset, chunk.count - 1));
+}
+
+// ---  ---
+
+ChunkedTrajectoryWriter::ChunkedTrajectoryWriter()
+    : m_dt(0.0),
+    m_pointCount(0),
+    m_failed(false) {
+}
+
+ChunkedTrajectoryWriter::~ChunkedTrajectoryWriter() {
+    if (m_file.is_open()) close();
+}
+
+bool ChunkedTrajectoryWriter::open(const std::string& path, double dt) {
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        std::cerr << "ChunkedTrajectoryWriter:    " << path << "  \n";
+        return false;
+    }
+    m_path = path;
+    m_dt = dt;
+    m_pointCount = 0;
+    m_index.clear();
+    m_failed = false;
+    m_chunkX.clear();
+    m_chunkY.clear();
+    m_chunkX.reserve(ChunkedTrajectoryFile::CHUNK_POINTS);
+    m_chunkY.reserve(ChunkedTrajectoryFile::CHUNK_POINTS);
+
+    //   :    close(),   
+    std::vector<char> placeholder(static_cast<size_t>(HEADER_SIZE), 0);
+    m_file.write(placeholder.data(), HEADER_SIZE);
+    return static_cast<bool>(m_file);
+}
+
+void ChunkedTrajectoryWriter::append(double x, double y) {
+    if (!m_file.is_open() || m_failed) return;
+    m_chunkX.push_back(static_cast<float>(x));
+    m_chunkY.push_back(static_cast<float>(y));
+    ++m_pointCount;
+    if (m_chunkX.size() == ChunkedTrajectoryFile::CHUNK_POINTS) {
+        flushChunk();
+    }
+}
+
+bool ChunkedTrajectoryWriter::flushChunk() {
+    if (m_chunkX.empty()) return true;
+    ChunkedTrajectoryFile::ChunkInfo info;
+    std::memset(&info, 0, sizeof(info));
+    info.firstIndex = m_pointCount - m_chunkX.size();
+    info.count = static_cast<uint32_t>(m_chunkX.size());
+    info.minX = *std::min_element(m_chunkX.begin(), m_chunkX.end());
+    info.maxX = *std::max_element(m_chunkX.begin(), m_chunkX.end());
+    info.minY = *std::min_element(m_chunkY.begin(), m_chunkY.end());
+    info.maxY = *std::max_element(m_chunkY.begin(), m_chunkY.end());
+
+    std::vector<float> levelX, levelY;
+    for (uint32_t level = 0; level < ChunkedTrajectoryFile::LOD_LEVELS; ++level) {
+        const uint32_t step = ChunkedTrajectoryFile::levelStep(level);
+        const uint32_t last = info.count - 1;
+        uint32_t levelCount = last / step + 1 + (last % step != 0 ? 1 : 0);
+        levelX.resize(levelCount);
+        levelY.resize(levelCount);
+        for (uint32_t j = 0; j < levelCount; ++j) {
+            uint32_t offset = ChunkedTrajectoryFile::levelPointOffset(info, level, j);
+            levelX[j] = m_chunkX[offset];
+            levelY[j] = m_chunkY[offset];
+        }
+        info.levelOffset[level] = static_cast<uint64_t>(m_file.tellp());
+        info.levelCount[level] = levelCount;
+        m_file.write(reinterpret_cast<const char*>(levelX.data()), levelCount * sizeof(float));
+        m_file.write(reinterpret_cast<const char*>(levelY.data()), levelCount * sizeof(float));
+    }
+    m_index.push_back(info);
+    m_chunkX.clear();
+    m_chunkY.clear();
+
+    if (!m_file) {
+        std::cerr << "ChunkedTrajectoryWriter:   " << m_path << "\n";
+        m_failed = true;
+    }
+    return !m_failed;
+}
+
+bool ChunkedTrajectoryWriter::close() {
+    if (!m_file.is_open()) return false;
+    flushChunk();
+
+    uint64_t indexOffset = static_cast<uint64_t>(m_file.tellp());
+    m_file.write(reinterpret_cast<const char*>(m_index.data()), m_index.size() * sizeof(ChunkedTrajectoryFile::ChunkInfo));
+
+    m_file.seekp(0);
+    m_file.write(CHUNKED_FILE_MAGIC, sizeof(CHUNKED_FILE_MAGIC));
+    writeValue(m_file, CHUNKED_FILE_FORMAT);
+    writeValue(m_file, ChunkedTrajectoryFile::CHUNK_POINTS);
+    writeValue(m_file, ChunkedTrajectoryFile::LOD_LEVELS);
+    writeValue(m_file, ChunkedTrajectoryFile::LOD_FACTOR);
+    writeValue(m_file, m_pointCount);
+    writeValue(m_file, static_cast<uint64_t>(m_index.size()));
+    writeValue(m_file, indexOffset);
+    writeValue(m_file, m_dt);
+
+    bool ok = static_cast<bool>(m_file) && !m_failed;
+    m_file.close();
+    if (!ok) {
+        std::cerr << "ChunkedTrajectoryWriter:  " << m_path << "   \n";
+    }
+    return ok;
+}
+
+bool ChunkedTrajectoryWriter::writeSimulation(const SimulationParameters& params, const std::string& path) {
+    ChunkedTrajectoryWriter writer;
+    if (!writer.open(path, params.DT)) return false;
+
+    //   (   ) -   runSimulation
+    //      :     
+    Calculations calculator;
+    OrbitAnalytics analytics;
+    SimulationParameters initialOnly = params;
+    initialOnly.STEPS = 0;
+    std::vector<State> block;
+    calculator.runSimulation(initialOnly, block, &analytics);
+    writer.append(block.front().x, block.front().y);
+
+    const State& start = block.front();
+    bool collided = start.x * start.x + start.y * start.y < params.CENTRAL_BODY_RADIUS * params.CENTRAL_BODY_RADIUS;
+    //       .  long double  Kahan
+    //        double.
+    for (int done = 0; done < params.STEPS && !collided; ) {
+        int blockEnd = std::min(params.STEPS, done + SIMULATION_BLOCK_STEPS);
+        collided = calculator.continueSimulation(params, done, blockEnd, block, &analytics);
+        for (size_t i = 1; i < block.size(); ++i) {
+            writer.append(block[i].x, block[i].y);
+        }
+        done += static_cast<int>(block.size()) - 1;
+        State last = block.back();
+        block.clear();
+        block.push_back(last);
+    }
+
+    std::cout << "ChunkedTrajectoryWriter:  " << writer.getPointCount() << "   " << path << "\n";
+    analytics.printSummary(std::cout);
+    return writer.close();
+}
+
+// ---  ---
+
+ChunkedTrajectoryReader::ChunkedTrajectoryReader()
+    : m_pointCount(0),
+    m_dt(0.0) {
+}
+
+bool ChunkedTrajectoryReader::open(const std::string& path) {
+    m_file.open(path, std::ios::binary);
+    if (!m_file.is_open()) {
+        std::cerr << "ChunkedTrajectoryReader:    " << path << "\n";
+        return false;
+    }
+
+    char magic[4];
+    uint32_t format = 0, chunkPoints = 0, lodLevels = 0, lodFactor = 0;
+    uint64_t chunkCount = 0, indexOffset = 0;
+    m_file.read(magic, sizeof(magic));
+    bool ok = readValue(m_file, format) && readValue(m_file, chunkPoints) && readValue(m_file, lodLevels) &&
+        readValue(m_file, lodFactor) && readValue(m_file, m_pointCount) && readValue(m_file, chunkCount) &&
+        readValue(m_file, indexOffset) && readValue(m_file, m_dt);
+    if (!ok || std::memcmp(magic, CHUNKED_FILE_MAGIC, sizeof(magic)) != 0 || format != CHUNKED_FILE_FORMAT ||
+        chunkPoints != ChunkedTrajectoryFile::CHUNK_POINTS || lodLevels != ChunkedTrajectoryFile::LOD_LEVELS ||
+        lodFactor != ChunkedTrajectoryFile::LOD_FACTOR) {
+        std::cerr << "ChunkedTrajectoryReader: " << path << " -     \n";
+        m_file.close();
+        return false;
+    }
+
+    //       :       indexOffset,
+    //   chunkCount      
+    m_file.seekg(0, std::ios::end);
+    const std::streamoff fileSize = m_file.tellg();
+    const uint64_t indexBytes = fileSize >= 0 && indexOffset <= static_cast<uint64_t>(fileSize) ?
+        static_cast<uint64_t>(fileSize) - indexOffset : 1;
+    if (!m_file || indexOffset < static_cast<uint64_t>(HEADER_SIZE) ||
+        indexBytes % sizeof(ChunkedTrajectoryFile::ChunkInfo) != 0 ||
+        indexBytes / sizeof(ChunkedTrajectoryFile::ChunkInfo) != chunkCount) {
+        std::cerr << "ChunkedTrajectoryReader:    " << path << "\n";
+        m_file.close();
+        return false;
+    }
+
+    m_index.resize(static_cast<size_t>(chunkCount));
+    m_file.seekg(static_cast<std::streamoff>(indexOffset));
+    m_file.read(reinterpret_cast<char*>(m_index.data()),
+        static_cast<std::streamsize>(m_index.size() * sizeof(ChunkedTrajectoryFile::ChunkInfo)));
+    bool indexValid = static_cast<bool>(m_file);
+    //      : readLevel     
+    for (size_t i = 0; indexValid && i < m_index.size(); ++i) {
+        const ChunkedTrajectoryFile::ChunkInfo& info = m_index[i];
+        indexValid = info.count >= 1 && info.count <= ChunkedTrajectoryFile::CHUNK_POINTS;
+        for (uint32_t level = 0; indexValid && level < ChunkedTrajectoryFile::LOD_LEVELS; ++level) {
+            const uint64_t levelBytes = 2 * static_cast<uint64_t>(info.levelCount[level]) * sizeof(float);
+            indexValid = info.levelCount[level] <= info.count &&
+                info.levelOffset[level] >= static_cast<uint64_t>(HEADER_SIZE) &&
+                info.levelOffset[level] <= indexOffset && levelBytes <= indexOffset - info.levelOffset[level];
+        }
+    }
+    if (!indexValid) {
+        std::cerr << "ChunkedTrajectoryReader:    " << path << "\n";
+        m_index.clear();
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+bool ChunkedTrajectoryReader::readLevel(size_t chunk, uint32_t level, std::vector<float>& x, std::vector<float>& y) {
+    if (chunk >= m_index.size() || level >= ChunkedTrajectoryFile::LOD_LEVELS) return false;
+    const ChunkedTrajectoryFile::ChunkInfo& info = m_index[chunk];
+    const uint32_t count = info.levelCount[level];
+    x.resize(count);
+    y.resize(count);
+    m_file.clear();
+    m_file.seekg(static_cast<std::streamoff>(info.levelOffset[level]));
+    m_file.read(reinterpret_cast<char*>(x.data()), count * sizeof(float));
+    m_file.read(reinterpret_cast<char*>(y.data()), count * sizeof(float));
+    return static_cast<bool>(m_file);
+}
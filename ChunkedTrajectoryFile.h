@@ -0,0 +1,93 @@
+#ifndef CHUNKEDTRAJECTORYFILE_H
+#define CHUNKEDTRAJECTORYFILE_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+
+#include "Calculations.h"
+
+//          (out-of-core).
+//
+//  (x, y  float)     CHUNK_POINTS.    
+//  :  L   LOD_FACTOR^L-   ( ),
+//  0 -  .   ()      
+//   ,       :
+//       ,        .
+//
+// :  |   (  : float x[n], float y[n]) | 
+class ChunkedTrajectoryFile {
+public:
+    static constexpr uint32_t CHUNK_POINTS = 65536;
+    static constexpr uint32_t LOD_LEVELS = 3;
+    static constexpr uint32_t LOD_FACTOR = 16;
+
+    struct ChunkInfo {
+        uint64_t firstIndex;              //       
+        uint32_t count;                   //    (  0)
+        uint32_t reserved;
+        uint64_t levelOffset[LOD_LEVELS]; //     
+        uint32_t levelCount[LOD_LEVELS];  //   
+        uint32_t reserved2;
+        float minX, maxX, minY, maxY;
+    };
+
+    //    (   0)
+    static uint32_t levelStep(uint32_t level);
+    //    ( 0),   j-  
+    static uint32_t levelPointOffset(const ChunkInfo& chunk, uint32_t level, uint32_t j);
+};
+
+//  :    ,       ,
+//        .
+class ChunkedTrajectoryWriter {
+public:
+    ChunkedTrajectoryWriter();
+    ~ChunkedTrajectoryWriter();
+
+    bool open(const std::string& path, double dt);
+    void append(double x, double y);
+    bool close(); //    .  close()   
+
+    uint64_t getPointCount() const { return m_pointCount; }
+
+    //    params   ,      .
+    //    Calculations::continueSimulation.
+    static bool writeSimulation(const SimulationParameters& params, const std::string& path);
+
+private:
+    bool flushChunk();
+
+    std::ofstream m_file;
+    std::string m_path;
+    double m_dt;
+    uint64_t m_pointCount;
+    std::vector<float> m_chunkX, m_chunkY;
+    std::vector<ChunkedTrajectoryFile::ChunkInfo> m_index;
+    bool m_failed;
+};
+
+// :     open(),   -  
+class ChunkedTrajectoryReader {
+public:
+    ChunkedTrajectoryReader();
+
+    bool open(const std::string& path);
+    bool isOpen() const { return m_file.is_open(); }
+
+    uint64_t getPointCount() const { return m_pointCount; }
+    double getTimeStep() const { return m_dt; }
+    const std::vector<ChunkedTrajectoryFile::ChunkInfo>& getIndex() const { return m_index; }
+
+    //   level  chunk  x, y.  :   -  .
+    bool readLevel(size_t chunk, uint32_t level, std::vector<float>& x, std::vector<float>& y);
+
+private:
+    std::ifstream m_file;
+    uint64_t m_pointCount;
+    double m_dt;
+    std::vector<ChunkedTrajectoryFile::ChunkInfo> m_index;
+};
+
+#endif // CHUNKEDTRAJECTORYFILE_H
@@ -0,0 +1,256 @@
+#ifndef INTEGRATORCORE_H
+#define INTEGRATORCORE_H
+
+#include <cmath>
+
+#include "Calculations.h"
+#include "AtmosphereModel.h"
+
+//       4    
+// (float, double, long double).    Scalar    .
+//  Scalar = double       Calculations,
+//       .
+template <typename Scalar>
+class IntegratorCore {
+public:
+    typedef BasicState<Scalar> StateType;
+
+    explicit IntegratorCore(const SimulationParameters& params)
+        : m_G(static_cast<Scalar>(params.G)),
+        m_M(static_cast<Scalar>(params.M)),
+        m_radius(static_cast<Scalar>(params.CENTRAL_BODY_RADIUS)),
+        m_netPropulsionFactor(static_cast<Scalar>(params.THRUST_COEFFICIENT) - static_cast<Scalar>(params.DRAG_COEFFICIENT)),
+        m_atmosphere(params.ATMOSPHERE_DRAG != 0.0 ? params.ATMOSPHERE.get() : nullptr),
+        m_atmosphereDrag(static_cast<Scalar>(params.ATMOSPHERE_DRAG)) {
+    }
+
+    //     
+    StateType derivatives(const StateType& s) const {
+        Scalar r_squared = s.x * s.x + s.y * s.y;
+        if (r_squared == 0) {
+            return { s.vx, s.vy, 0, 0 };
+        }
+        Scalar r = std::sqrt(r_squared);
+        Scalar r_cubed = r_squared * r;
+
+        Scalar common_factor_gravity = -m_G * m_M / r_cubed;
+
+        Scalar ax = common_factor_gravity * s.x + m_netPropulsionFactor * s.vx;
+        Scalar ay = common_factor_gravity * s.y + m_netPropulsionFactor * s.vy;
+        if (m_atmosphere) {
+            Scalar speed = std::sqrt(s.vx * s.vx + s.vy * s.vy);
+            Scalar density = static_cast<Scalar>(m_atmosphere->density(static_cast<double>(r - m_radius)));
+            Scalar factor = -m_atmosphereDrag * density * speed;
+            ax += factor * s.vx;
+            ay += factor * s.vy;
+        }
+        return { s.vx, s.vy, ax, ay };
+    }
+
+    //      4: s(t + dt) = s + increment.
+    //   ,       .
+    StateType rungeKuttaIncrement(const StateType& s, Scalar dt) const {
+        const Scalar two = 2;
+        const Scalar six = 6;
+        StateType k1 = derivatives(s);
+
+        StateType s_temp_k2 = {
+            s.x + dt * k1.x / two,
+            s.y + dt * k1.y / two,
+            s.vx + dt * k1.vx / two,
+            s.vy + dt * k1.vy / two
+        };
+        StateType k2 = derivatives(s_temp_k2);
+
+        StateType s_temp_k3 = {
+            s.x + dt * k2.x / two,
+            s.y + dt * k2.y / two,
+            s.vx + dt * k2.vx / two,
+            s.vy + dt * k2.vy / two
+        };
+        StateType k3 = derivatives(s_temp_k3);
+
+        StateType s_temp_k4 = {
+            s.x + dt * k3.x,
+            s.y + dt * k3.y,
+            s.vx + dt * k3.vx,
+            s.vy + dt * k3.vy
+        };
+        StateType k4 = derivatives(s_temp_k4);
+
+        return {
+            dt / six * (k1.x + two * k2.x + two * k3.x + k4.x),
+            dt / six * (k1.y + two * k2.y + two * k3.y + k4.y),
+            dt / six * (k1.vx + two * k2.vx + two * k3.vx + k4.vx),
+            dt / six * (k1.vy + two * k2.vy + two * k3.vy + k4.vy)
+        };
+    }
+
+    //  4    s ,    (dt/ds = r):
+    //   s -  derivatives(),   r.   
+    //  ,       timeIncrement.
+    StateType sundmanIncrement(const StateType& s, Scalar ds, Scalar& timeIncrement) const {
+        const Scalar two = 2;
+        const Scalar six = 6;
+        Scalar r1, r2, r3, r4;
+        StateType k1 = regularizedDerivatives(s, r1);
+
+        StateType s_temp_k2 = {
+            s.x + ds * k1.x / two,
+            s.y + ds * k1.y / two,
+            s.vx + ds * k1.vx / two,
+            s.vy + ds * k1.vy / two
+        };
+        StateType k2 = regularizedDerivatives(s_temp_k2, r2);
+
+        StateType s_temp_k3 = {
+            s.x + ds * k2.x / two,
+            s.y + ds * k2.y / two,
+            s.vx + ds * k2.vx / two,
+            s.vy + ds * k2.vy / two
+        };
+        StateType k3 = regularizedDerivatives(s_temp_k3, r3);
+
+        StateType s_temp_k4 = {
+            s.x + ds * k3.x,
+            s.y + ds * k3.y,
+            s.vx + ds * k3.vx,
+            s.vy + ds * k3.vy
+        };
+        StateType k4 = regularizedDerivatives(s_temp_k4, r4);
+
+        timeIncrement = ds / six * (r1 + two * r2 + two * r3 + r4);
+        return {
+            ds / six * (k1.x + two * k2.x + two * k3.x + k4.x),
+            ds / six * (k1.y + two * k2.y + two * k3.y + k4.y),
+            ds / six * (k1.vx + two * k2.vx + two * k3.vx + k4.vx),
+            ds / six * (k1.vy + two * k2.vy + two * k3.vy + k4.vy)
+        };
+    }
+
+    StateType rungeKuttaStep(const StateType& s, Scalar dt) const {
+        StateType increment = rungeKuttaIncrement(s, dt);
+        return { s.x + increment.x, s.y + increment.y, s.vx + increment.vx, s.vy + increment.vy };
+    }
+
+    bool isInsideCentralBody(const StateType& s) const {
+        return s.x * s.x + s.y * s.y < m_radius * m_radius;
+    }
+
+    //      : [x, y, vx, vy],  
+    // Phi = d state / d state(0) (4x4  ),  d state / d(F - k)
+    static constexpr int VARIATIONAL_SIZE = 4 + 16 + 4;
+    static constexpr int PHI_OFFSET = 4;
+    static constexpr int PROPULSION_OFFSET = 20;
+
+    //    : Phi' = A Phi, P' = A P + df/d(F - k),  A - 
+    //   (   ). r         24 ,   -
+    //   ,   derivatives(),       4.
+    void variationalDerivatives(const Scalar* v, Scalar* d) const {
+        const Scalar* phi = v + PHI_OFFSET;
+        const Scalar* propulsion = v + PROPULSION_OFFSET;
+        Scalar r_squared = v[0] * v[0] + v[1] * v[1];
+        //    ax  ay  (x, y, vx, vy);   x  y -   vx  vy
+        Scalar jx[4] = { 0, 0, m_netPropulsionFactor, 0 };
+        Scalar jy[4] = { 0, 0, 0, m_netPropulsionFactor };
+        d[0] = v[2];
+        d[1] = v[3];
+        if (r_squared == 0) {
+            d[2] = 0;
+            d[3] = 0;
+        }
+        else {
+            Scalar r = std::sqrt(r_squared);
+            Scalar r_cubed = r_squared * r;
+            Scalar common_factor_gravity = -m_G * m_M / r_cubed;
+            d[2] = common_factor_gravity * v[0] + m_netPropulsionFactor * v[2];
+            d[3] = common_factor_gravity * v[1] + m_netPropulsionFactor * v[3];
+
+            Scalar tidal = -3 * common_factor_gravity / r_squared; // 3 mu / r^5
+            jx[0] = common_factor_gravity + tidal * v[0] * v[0];
+            jx[1] = tidal * v[0] * v[1];
+            jy[0] = jx[1];
+            jy[1] = common_factor_gravity + tidal * v[1] * v[1];
+
+            if (m_atmosphere) {
+                // a = -c rho(h) |v| v:   -c rho (|v| I + v v^T / |v|),   -c rho' |v| v r^T / r
+                double densitySlope = 0.0;
+                Scalar speed = std::sqrt(v[2] * v[2] + v[3] * v[3]);
+                Scalar density = static_cast<Scalar>(m_atmosphere->density(static_cast<double>(r - m_radius), densitySlope));
+                Scalar factor = -m_atmosphereDrag * density * speed;
+                d[2] += factor * v[2];
+                d[3] += factor * v[3];
+
+                Scalar radial = -m_atmosphereDrag * static_cast<Scalar>(densitySlope) * speed / r;
+                jx[0] += radial * v[2] * v[0];
+                jx[1] += radial * v[2] * v[1];
+                jy[0] += radial * v[3] * v[0];
+                jy[1] += radial * v[3] * v[1];
+                Scalar cross = speed > 0 ? -m_atmosphereDrag * density / speed : 0;
+                jx[2] += factor + cross * v[2] * v[2];
+                jx[3] += cross * v[2] * v[3];
+                jy[2] += cross * v[3] * v[2];
+                jy[3] += factor + cross * v[3] * v[3];
+            }
+        }
+        Scalar* dPhi = d + PHI_OFFSET;
+        for (int column = 0; column < 4; ++column) {
+            dPhi[column] = phi[8 + column];
+            dPhi[4 + column] = phi[12 + column];
+            dPhi[8 + column] = jx[0] * phi[column] + jx[1] * phi[4 + column] + jx[2] * phi[8 + column] + jx[3] * phi[12 + column];
+            dPhi[12 + column] = jy[0] * phi[column] + jy[1] * phi[4 + column] + jy[2] * phi[8 + column] + jy[3] * phi[12 + column];
+        }
+        Scalar* dPropulsion = d + PROPULSION_OFFSET;
+        dPropulsion[0] = propulsion[2];
+        dPropulsion[1] = propulsion[3];
+        dPropulsion[2] = jx[0] * propulsion[0] + jx[1] * propulsion[1] + jx[2] * propulsion[2] + jx[3] * propulsion[3] + v[2];
+        dPropulsion[3] = jy[0] * propulsion[0] + jy[1] * propulsion[1] + jy[2] * propulsion[2] + jy[3] * propulsion[3] + v[3];
+    }
+
+    //  4     (v - VARIATIONAL_SIZE )
+    void variationalStep(Scalar* v, Scalar dt) const {
+        const Scalar two = 2;
+        const Scalar six = 6;
+        Scalar k1[VARIATIONAL_SIZE], k2[VARIATIONAL_SIZE], k3[VARIATIONAL_SIZE], k4[VARIATIONAL_SIZE];
+        Scalar temp[VARIATIONAL_SIZE];
+        variationalDerivatives(v, k1);
+        for (int i = 0; i < VARIATIONAL_SIZE; ++i) temp[i] = v[i] + dt * k1[i] / two;
+        variationalDerivatives(temp, k2);
+        for (int i = 0; i < VARIATIONAL_SIZE; ++i) temp[i] = v[i] + dt * k2[i] / two;
+        variationalDerivatives(temp, k3);
+        for (int i = 0; i < VARIATIONAL_SIZE; ++i) temp[i] = v[i] + dt * k3[i];
+        variationalDerivatives(temp, k4);
+        for (int i = 0; i < VARIATIONAL_SIZE; ++i) v[i] += dt / six * (k1[i] + two * k2[i] + two * k3[i] + k4[i]);
+    }
+
+    Scalar radius(const StateType& s) const {
+        return std::sqrt(s.x * s.x + s.y * s.y);
+    }
+
+private:
+    // d/ds = r d/dt; r (  dt/ds)  
+    StateType regularizedDerivatives(const StateType& s, Scalar& r) const {
+        r = radius(s);
+        StateType d = derivatives(s);
+        return { r * d.x, r * d.y, r * d.vx, r * d.vy };
+    }
+
+    Scalar m_G;
+    Scalar m_M;
+    Scalar m_radius;
+    Scalar m_netPropulsionFactor;
+    const AtmosphereModel* m_atmosphere; // nullptr -   
+    Scalar m_atmosphereDrag;
+};
+
+//   : value += increment, compensation    .
+//  1e8+         .
+template <typename Scalar>
+inline void compensatedAdd(Scalar& value, Scalar increment, Scalar& compensation) {
+    Scalar y = increment - compensation;
+    Scalar t = value + y;
+    compensation = (t - value) - y;
+    value = t;
+}
+
+#endif // INTEGRATORCORE_H
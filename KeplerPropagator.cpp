@@ -0,0 +1,219 @@
+#include "KeplerPropagator.h"
+#include "OrbitAnalytics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+const double TWO_PI = 6.283185307179586476925286766559;
+const double PI = 3.1415926535897932384626433832795;
+
+//     
+struct KeplerElements {
+    bool elliptic;
+    double axis;      // a  , |a|  
+    double meanMotion;
+    double eCos0;     // : e cos E0 = 1 - r0/a.   : e cosh H0 = 1 + r0/|a|
+    double eSin0;     // : e sin E0 = (r0.v0)/sqrt(mu a).   : e sinh H0 = (r0.v0)/sqrt(mu |a|)
+    double anomaly0;  // E0  H0
+    double meanAnomaly0;
+    double eccentricity;
+};
+
+// sin d  1 - cos d  |d| <= 0.5   ( < 1e-18):   libm,
+//       
+inline double sinSmall(double d) {
+    const double d2 = d * d;
+    return d * (1.0 + d2 * (-1.0 / 6 + d2 * (1.0 / 120 + d2 * (-1.0 / 5040 + d2 * (1.0 / 362880 +
+        d2 * (-1.0 / 39916800 + d2 * (1.0 / 6227020800.0 + d2 * (-1.0 / 1307674368000.0))))))));
+}
+
+inline double oneMinusCosSmall(double d) {
+    const double d2 = d * d;
+    return d2 * (1.0 / 2 + d2 * (-1.0 / 24 + d2 * (1.0 / 720 + d2 * (-1.0 / 40320 + d2 * (1.0 / 3628800 +
+        d2 * (-1.0 / 479001600 + d2 * (1.0 / 87178291200.0 + d2 * (-1.0 / 20922789888000.0))))))));
+}
+
+//     : x + eSin0 (1 - cos x) - eCos0 sin x = dm,  r/a > 0.
+//  ,     -    .
+double solveEllipticPoint(const KeplerElements& el, double dm, int maxIterations) {
+    double meanAnomaly = el.meanAnomaly0 + dm;
+    meanAnomaly -= TWO_PI * std::floor((meanAnomaly + PI) / TWO_PI);
+    const double guess = meanAnomaly + 0.85 * el.eccentricity * (std::sin(meanAnomaly) < 0.0 ? -1.0 : 1.0);
+    double x = guess - el.anomaly0;
+    x += TWO_PI * std::floor((dm - x + PI) / TWO_PI); //  -   pi  dm
+    for (int iteration = 0; iteration < maxIterations; ++iteration) {
+        const double s = std::sin(x);
+        const double c = std::cos(x);
+        const double correction = (x + el.eSin0 * (1.0 - c) - el.eCos0 * s - dm) / (1.0 + el.eSin0 * s - el.eCos0 * c);
+        x -= correction;
+        if (std::abs(correction) < 1e-15) break;
+    }
+    return x;
+}
+
+// : eSin0 (cosh x - 1) + eCos0 sinh x - x = dm,  r/|a| > 0
+double solveHyperbolicPoint(const KeplerElements& el, double dm, double guess, int maxIterations) {
+    double x = guess;
+    for (int iteration = 0; iteration < maxIterations; ++iteration) {
+        const double s = std::sinh(x);
+        const double c = std::cosh(x);
+        const double correction = (el.eSin0 * (c - 1.0) + el.eCos0 * s - x - dm) / (el.eSin0 * s + el.eCos0 * c - 1.0);
+        x -= correction;
+        if (std::abs(correction) < 1e-15 * std::max(1.0, std::abs(x))) break;
+    }
+    return x;
+}
+}
+
+constexpr int KeplerPropagator::BLOCK_SIZE;
+constexpr int KeplerPropagator::MAX_NEWTON_ITERATIONS;
+constexpr double KeplerPropagator::PARABOLIC_TOLERANCE;
+
+bool KeplerPropagator::isApplicable(const SimulationParameters& params) {
+    return params.ANALYTIC_KEPLER && params.DRAG_COEFFICIENT == 0.0 && params.THRUST_COEFFICIENT == 0.0 &&
+        (params.ATMOSPHERE_DRAG == 0.0 || !params.ATMOSPHERE) && params.G * params.M > 0.0;
+}
+
+bool KeplerPropagator::propagate(const SimulationParameters& params, const State& start, int firstStep, int lastStep,
+    StateSink& sink, OrbitAnalytics* analytics, bool& collided, bool verbose) {
+    collided = false;
+    const double mu = params.G * params.M;
+    const double r0 = std::sqrt(start.x * start.x + start.y * start.y);
+    if (r0 == 0.0) return false;
+    const double v0Squared = start.vx * start.vx + start.vy * start.vy;
+    const double radialProduct = start.x * start.vx + start.y * start.vy; // r0 . v0
+    const double inverseAxis = 2.0 / r0 - v0Squared / mu;                 // 1/a (vis-viva)
+    if (std::abs(inverseAxis) * r0 < PARABOLIC_TOLERANCE) {
+        if (verbose) std::cout << "KeplerPropagator:   ,  4\n";
+        return false;
+    }
+
+    KeplerElements el;
+    el.elliptic = inverseAxis > 0.0;
+    el.axis = 1.0 / std::abs(inverseAxis);
+    el.meanMotion = std::sqrt(mu / (el.axis * el.axis * el.axis));
+    el.eSin0 = radialProduct / std::sqrt(mu * el.axis);
+    if (el.elliptic) {
+        el.eCos0 = 1.0 - r0 / el.axis;
+        el.eccentricity = std::sqrt(el.eCos0 * el.eCos0 + el.eSin0 * el.eSin0);
+        el.anomaly0 = std::atan2(el.eSin0, el.eCos0);
+        el.meanAnomaly0 = el.anomaly0 - el.eSin0;
+    }
+    else {
+        el.eCos0 = 1.0 + r0 / el.axis;
+        el.eccentricity = std::sqrt(el.eCos0 * el.eCos0 - el.eSin0 * el.eSin0);
+        el.anomaly0 = std::asinh(el.eSin0 / el.eccentricity);
+        el.meanAnomaly0 = el.eSin0 - el.anomaly0;
+    }
+    const double sqrtMuAxis = std::sqrt(mu * el.axis);
+    const double signedAxis = el.elliptic ? el.axis : -el.axis;
+    const double sigma0 = radialProduct / std::sqrt(mu) * std::sqrt(el.axis); // (r0.v0) sqrt(|a|/mu)
+    const double radiusSquared = params.CENTRAL_BODY_RADIUS * params.CENTRAL_BODY_RADIUS;
+    const double meanMotionStep = el.meanMotion * params.DT;
+
+    // :        d <= u * a/r <= u / (1 - e),  u -
+    //   .   ,  |d| <= 0.5    sinSmall.
+    int blockLength = 1;
+    if (el.elliptic && meanMotionStep > 0.0) {
+        const double samples = 0.5 * (1.0 - el.eccentricity) / meanMotionStep;
+        blockLength = static_cast<int>(std::max(1.0, std::min(static_cast<double>(BLOCK_SIZE), samples)));
+    }
+
+    double offset[BLOCK_SIZE]; // u:      
+    double delta[BLOCK_SIZE];  // d:     
+    double hyperbolicGuess = 0.0;
+    for (int blockStart = firstStep + 1; blockStart <= lastStep; blockStart += blockLength) {
+        const int count = std::min(blockLength, lastStep - blockStart + 1);
+        const double anchorTime = static_cast<double>(blockStart - firstStep) * params.DT;
+
+        //     .      
+        //   -      [-pi, pi)
+        double anchorMean = el.meanMotion * anchorTime;
+        double anchorReducedTime = anchorTime;
+        double anchor;
+        if (el.elliptic) {
+            anchorMean -= TWO_PI * std::floor((anchorMean + PI) / TWO_PI);
+            anchorReducedTime = anchorMean / el.meanMotion;
+            anchor = solveEllipticPoint(el, anchorMean, MAX_NEWTON_ITERATIONS);
+        }
+        else {
+            if (blockStart == firstStep + 1) {
+                hyperbolicGuess = std::asinh((el.meanAnomaly0 + anchorMean) / el.eccentricity) - el.anomaly0;
+            }
+            anchor = solveHyperbolicPoint(el, anchorMean, hyperbolicGuess, MAX_NEWTON_ITERATIONS);
+            hyperbolicGuess = anchor + meanMotionStep * el.axis / std::max(r0 * 1e-3,
+                signedAxis + (r0 - signedAxis) * std::cosh(anchor) + sigma0 * std::sinh(anchor));
+        }
+        const double sinAnchor = el.elliptic ? std::sin(anchor) : 0.0;
+        const double cosAnchor = el.elliptic ? std::cos(anchor) : 1.0;
+
+        //   :   d    . sin  cos  -
+        // ,          
+        if (el.elliptic) {
+            const double anchorSlope = 1.0 / (1.0 + el.eSin0 * sinAnchor - el.eCos0 * cosAnchor); // a/r
+            for (int i = 0; i < count; ++i) {
+                offset[i] = meanMotionStep * i;
+                delta[i] = offset[i] * anchorSlope;
+            }
+            for (int iteration = 0; iteration < MAX_NEWTON_ITERATIONS; ++iteration) {
+                double maxCorrection = 0.0;
+                for (int i = 0; i < count; ++i) {
+                    const double sd = sinSmall(delta[i]);
+                    const double omc = oneMinusCosSmall(delta[i]);
+                    // G(d) = d + eSin0 (cos A - cos(A + d)) - eCos0 (sin(A + d) - sin A) - u
+                    const double g = delta[i] + el.eSin0 * (cosAnchor * omc + sinAnchor * sd) -
+                        el.eCos0 * (cosAnchor * sd - sinAnchor * omc) - offset[i];
+                    const double sinX = sinAnchor * (1.0 - omc) + cosAnchor * sd;
+                    const double cosX = cosAnchor * (1.0 - omc) - sinAnchor * sd;
+                    const double correction = g / (1.0 + el.eSin0 * sinX - el.eCos0 * cosX);
+                    delta[i] -= correction;
+                    maxCorrection = std::max(maxCorrection, std::abs(correction));
+                }
+                if (maxCorrection < 1e-15) break;
+            }
+        }
+        else {
+            delta[0] = 0.0;
+        }
+
+        //  : r = f r0 + g v0, v = fDot r0 + gDot v0
+        for (int i = 0; i < count; ++i) {
+            double oneMinusCos, sinTerm, anomalyMinusSin;
+            if (el.elliptic) {
+                const double sd = sinSmall(delta[i]);
+                const double omc = oneMinusCosSmall(delta[i]);
+                sinTerm = sinAnchor * (1.0 - omc) + cosAnchor * sd;
+                oneMinusCos = 1.0 - (cosAnchor * (1.0 - omc) - sinAnchor * sd);
+                anomalyMinusSin = anchor + delta[i] - sinTerm;
+            }
+            else {
+                sinTerm = std::sinh(anchor);
+                oneMinusCos = 1.0 - std::cosh(anchor); //        a
+                anomalyMinusSin = anchor - sinTerm;
+            }
+            const double reducedTime = anchorReducedTime + params.DT * i;
+            const double r = signedAxis + (r0 - signedAxis) * (1.0 - oneMinusCos) + sigma0 * sinTerm;
+            const double f = 1.0 - signedAxis / r0 * oneMinusCos;
+            const double g = reducedTime - anomalyMinusSin / el.meanMotion * (el.elliptic ? 1.0 : -1.0);
+            const double fDot = -sqrtMuAxis * sinTerm / (r * r0);
+            const double gDot = 1.0 - signedAxis / r * oneMinusCos;
+
+            const State stored = {
+                f * start.x + g * start.vx, f * start.y + g * start.vy,
+                fDot * start.x + gDot * start.vx, fDot * start.y + gDot * start.vy };
+            sink.push(stored);
+            if (analytics) analytics->addState(stored);
+
+            if (stored.x * stored.x + stored.y * stored.y < radiusSquared) {
+                if (verbose) std::cout << "    " << blockStart + i
+                    << " ( ). : (" << stored.x << ", " << stored.y
+                    << "), r = " << std::sqrt(stored.x * stored.x + stored.y * stored.y) << "\n";
+                collided = true;
+                return true;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,41 @@
+#ifndef KEPLERPROPAGATOR_H
+#define KEPLERPROPAGATOR_H
+
+#include <vector>
+
+#include "Calculations.h"
+
+class OrbitAnalytics;
+
+//           .
+//       ( , e*cos E0, e*sin E0),
+//          
+//  (  - ) .   
+//     f, g.      
+//   ,     ,  
+//    ,    .
+//
+//     ( BLOCK_SIZE):    - ,  -
+//  .       , sin  cos  
+//  ,        .
+//           .
+class KeplerPropagator {
+public:
+    //    :    ,     params
+    static bool isApplicable(const SimulationParameters& params);
+
+    //   sink  firstStep+1..lastStep,    start   firstStep
+    // ( Calculations::continueSimulation). collided -    .
+    //  false    ,     -   4.
+    // verbose = false -    std::cout.
+    static bool propagate(const SimulationParameters& params, const State& start, int firstStep, int lastStep,
+        StateSink& sink, OrbitAnalytics* analytics, bool& collided, bool verbose = true);
+
+private:
+    static constexpr int BLOCK_SIZE = 256;
+    static constexpr int MAX_NEWTON_ITERATIONS = 50;
+    //    (|1/a| * r0  )     
+    static constexpr double PARABOLIC_TOLERANCE = 1e-8;
+};
+
+#endif // KEPLERPROPAGATOR_H
@@ -0,0 +1,545 @@
+#include "NBodyCalculations.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+//           
+const size_t PARALLEL_MIN_BODIES = 128;
+//   : ,   ,    
+const int QUADTREE_MAX_DEPTH = 48;
+
+unsigned int resolveThreadCount(unsigned int requested) {
+    if (requested > 0) return requested;
+    unsigned int hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+//   ,    .   4    4,  
+//  std::thread         -   
+//   condition_variable,      .
+class WorkerPool {
+public:
+    explicit WorkerPool(unsigned int threadCount) {
+        for (unsigned int t = 1; t < threadCount; ++t) {
+            m_threads.emplace_back([this, t]() { workerLoop(t); });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_start.notify_all();
+        for (auto& thread : m_threads) thread.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    //   [0, count)      ; fn(begin, end)   .
+    //     ,  -  ,    .
+    template <typename Fn>
+    void parallelFor(size_t count, Fn fn) {
+        if (count < PARALLEL_MIN_BODIES || m_threads.empty()) {
+            fn(size_t(0), count);
+            return;
+        }
+        const size_t chunkSize = (count + m_threads.size()) / (m_threads.size() + 1);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_invoke = &invoke<Fn>;
+            m_context = &fn;
+            m_count = count;
+            m_chunkSize = chunkSize;
+            m_pending = m_threads.size();
+            ++m_generation;
+        }
+        m_start.notify_all();
+        fn(size_t(0), std::min(count, chunkSize));
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this]() { return m_pending == 0; });
+    }
+
+private:
+    template <typename Fn>
+    static void invoke(void* context, size_t begin, size_t end) {
+        (*static_cast<Fn*>(context))(begin, end);
+    }
+
+    void workerLoop(size_t workerIndex) {
+        uint64_t seenGeneration = 0;
+        while (true) {
+            void (*task)(void*, size_t, size_t) = nullptr;
+            void* context = nullptr;
+            size_t begin = 0, end = 0;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_start.wait(lock, [&]() { return m_stop || m_generation != seenGeneration; });
+                if (m_stop) return;
+                seenGeneration = m_generation;
+                task = m_invoke;
+                context = m_context;
+                begin = workerIndex * m_chunkSize;
+                end = std::min(m_count, begin + m_chunkSize);
+            }
+            if (begin < end) task(context, begin, end);
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_pending == 0) m_done.notify_one();
+        }
+    }
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_start, m_done;
+    void (*m_invoke)(void*, size_t, size_t) = nullptr;
+    void* m_context = nullptr;
+    size_t m_count = 0;
+    size_t m_chunkSize = 0;
+    size_t m_pending = 0;
+    uint64_t m_generation = 0;
+    bool m_stop = false;
+};
+
+//   Barnes-Hut.      : firstChild .. firstChild + 3.
+struct QuadNode {
+    double cx, cy;      //   
+    double halfSize;    //   
+    double mass;        //    
+    double comX, comY;  //    
+    int firstChild;     // -1 - 
+    int body;           // :  , EMPTY_LEAF  MERGED_LEAF
+};
+
+const int EMPTY_LEAF = -1;
+const int MERGED_LEAF = -2; //    ,   
+
+class QuadTree {
+public:
+    //    ,      
+    void build(const double* x, const double* y, const std::vector<double>& mass,
+        const std::vector<unsigned char>& active) {
+        m_nodes.clear();
+        size_t n = mass.size();
+
+        double minX = 0, maxX = 0, minY = 0, maxY = 0;
+        bool first = true;
+        for (size_t i = 0; i < n; ++i) {
+            if (!active[i] || mass[i] <= 0) continue;
+            if (first) { minX = maxX = x[i]; minY = maxY = y[i]; first = false; continue; }
+            minX = std::min(minX, x[i]); maxX = std::max(maxX, x[i]);
+            minY = std::min(minY, y[i]); maxY = std::max(maxY, y[i]);
+        }
+        if (first) return; //      -  
+
+        double halfSize = 0.5 * std::max(maxX - minX, maxY - minY);
+        halfSize = halfSize * 1.0001 + 1e-12; // ,     
+        m_nodes.reserve(4 * n + 1);
+        m_nodes.push_back(makeLeaf(0.5 * (minX + maxX), 0.5 * (minY + maxY), halfSize));
+
+        for (size_t i = 0; i < n; ++i) {
+            if (!active[i] || mass[i] <= 0) continue;
+            insert(static_cast<int>(i), x, y, mass);
+        }
+    }
+
+    // ,    bodyIndex (   ,  bodyIndex < 0)
+    void accelerationAt(double px, double py, int bodyIndex, double thetaSquared, double softeningSquared,
+        double G, double& ax, double& ay, std::vector<int>& stack) const {
+        ax = 0.0; ay = 0.0;
+        if (m_nodes.empty()) return;
+        stack.clear();
+        stack.push_back(0);
+        while (!stack.empty()) {
+            const QuadNode& node = m_nodes[stack.back()];
+            stack.pop_back();
+            if (node.mass <= 0) continue;
+            if (node.firstChild < 0 && node.body == bodyIndex) continue; //    
+
+            double dx = node.comX - px;
+            double dy = node.comY - py;
+            double distSquared = dx * dx + dy * dy + softeningSquared;
+            double size = 2.0 * node.halfSize;
+
+            if (node.firstChild < 0 || size * size < thetaSquared * distSquared) {
+                double invDist = 1.0 / std::sqrt(distSquared);
+                double factor = G * node.mass * invDist * invDist * invDist;
+                ax += factor * dx;
+                ay += factor * dy;
+            }
+            else {
+                for (int c = 0; c < 4; ++c) stack.push_back(node.firstChild + c);
+            }
+        }
+    }
+
+private:
+    std::vector<QuadNode> m_nodes;
+
+    static QuadNode makeLeaf(double cx, double cy, double halfSize) {
+        return { cx, cy, halfSize, 0.0, 0.0, 0.0, -1, EMPTY_LEAF };
+    }
+
+    static void addMass(QuadNode& node, double bx, double by, double bm) {
+        double total = node.mass + bm;
+        node.comX = (node.comX * node.mass + bx * bm) / total;
+        node.comY = (node.comY * node.mass + by * bm) / total;
+        node.mass = total;
+    }
+
+    int childFor(int nodeIndex, double px, double py) const {
+        const QuadNode& node = m_nodes[nodeIndex];
+        int quadrant = (px >= node.cx ? 1 : 0) + (py >= node.cy ? 2 : 0);
+        return node.firstChild + quadrant;
+    }
+
+    void subdivide(int nodeIndex) {
+        double cx = m_nodes[nodeIndex].cx;
+        double cy = m_nodes[nodeIndex].cy;
+        double h = 0.5 * m_nodes[nodeIndex].halfSize;
+        int first = static_cast<int>(m_nodes.size());
+        m_nodes.push_back(makeLeaf(cx - h, cy - h, h)); // 0:  
+        m_nodes.push_back(makeLeaf(cx + h, cy - h, h)); // 1:  
+        m_nodes.push_back(makeLeaf(cx - h, cy + h, h)); // 2:  
+        m_nodes.push_back(makeLeaf(cx + h, cy + h, h)); // 3:  
+        m_nodes[nodeIndex].firstChild = first; //   m_nodes   -   
+    }
+
+    void insert(int body, const double* x, const double* y, const std::vector<double>& mass) {
+        int nodeIndex = 0;
+        int depth = 0;
+        while (true) {
+            if (m_nodes[nodeIndex].firstChild < 0) {
+                QuadNode& leaf = m_nodes[nodeIndex];
+                if (leaf.body == EMPTY_LEAF && leaf.mass <= 0) {
+                    leaf.body = body;
+                    addMass(leaf, x[body], y[body], mass[body]);
+                    return;
+                }
+                if (depth >= QUADTREE_MAX_DEPTH || leaf.body == MERGED_LEAF) {
+                    leaf.body = MERGED_LEAF;
+                    addMass(leaf, x[body], y[body], mass[body]);
+                    return;
+                }
+                //     :        
+                int oldBody = leaf.body;
+                subdivide(nodeIndex);
+                m_nodes[nodeIndex].body = EMPTY_LEAF;
+                QuadNode& child = m_nodes[childFor(nodeIndex, x[oldBody], y[oldBody])];
+                child.body = oldBody;
+                addMass(child, x[oldBody], y[oldBody], mass[oldBody]);
+            }
+            addMass(m_nodes[nodeIndex], x[body], y[body], mass[body]);
+            nodeIndex = childFor(nodeIndex, x[body], y[body]);
+            ++depth;
+        }
+    }
+};
+
+} // namespace
+
+struct NBodyCalculations::Workspace {
+    std::vector<double> kx[4], ky[4], kvx[4], kvy[4]; //    4
+    std::vector<double> sx, sy, svx, svy;             //   
+    std::vector<double> ax, ay;                       //  
+    QuadTree tree;                                    //  -,    
+    WorkerPool pool;                                  //   ,   
+
+    //  ,       
+    Workspace(size_t n, unsigned int threadCount)
+        : pool(n >= PARALLEL_MIN_BODIES ? threadCount : 1) {
+        for (int s = 0; s < 4; ++s) {
+            kx[s].resize(n); ky[s].resize(n); kvx[s].resize(n); kvy[s].resize(n);
+        }
+        sx.resize(n); sy.resize(n); svx.resize(n); svy.resize(n);
+        ax.resize(n); ay.resize(n);
+    }
+};
+
+void BodySystem::addBody(double bx, double by, double bvx, double bvy, double bodyMass) {
+    x.push_back(bx);
+    y.push_back(by);
+    vx.push_back(bvx);
+    vy.push_back(bvy);
+    mass.push_back(bodyMass);
+}
+
+void BodySystem::reserve(size_t count) {
+    x.reserve(count); y.reserve(count);
+    vx.reserve(count); vy.reserve(count);
+    mass.reserve(count);
+}
+
+NBodyCalculations::NBodyCalculations() {
+}
+
+BodySystem NBodyCalculations::fromSingleSatellite(const SimulationParameters& params) {
+    BodySystem bodies;
+    bodies.addBody(params.initialState.x, params.initialState.y,
+        params.initialState.vx, params.initialState.vy, 0.0); //  -  
+    return bodies;
+}
+
+bool NBodyCalculations::loadBodies(const std::string& path, BodySystem& bodies) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "NBodyCalculations:    " << path << "\n";
+        return false;
+    }
+    bodies = BodySystem();
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        const size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue; //  
+        std::istringstream fields(line);
+        fields.imbue(std::locale::classic()); //      
+        double bx, by, bvx, bvy, bodyMass;
+        std::string rest;
+        if (!(fields >> bx >> by >> bvx >> bvy >> bodyMass) || (fields >> rest) || bodyMass < 0.0) {
+            std::cerr << "NBodyCalculations: " << path << ":" << lineNumber
+                << ":  \"x y vx vy mass\"  mass >= 0\n";
+            return false;
+        }
+        bodies.addBody(bx, by, bvx, bvy, bodyMass);
+    }
+    return true;
+}
+
+NBodyTrajectory NBodyCalculations::runSimulation(const BodySystem& initialBodies, const NBodyParameters& params) {
+    NBodyTrajectory trajectory;
+    const size_t n = initialBodies.size();
+    trajectory.bodyCount = n;
+    trajectory.crashed.assign(n, 0);
+    if (n == 0) return trajectory;
+
+    const int recordEvery = std::max(1, params.RECORD_EVERY);
+    const size_t expectedSnapshots = static_cast<size_t>(std::max(0, params.STEPS)) / recordEvery + 2;
+
+    //  :      -     
+    if (n == 1 && params.CENTRAL_MASS > 0) {
+        SimulationParameters single;
+        single.G = params.G;
+        single.M = params.CENTRAL_MASS;
+        single.CENTRAL_BODY_RADIUS = params.CENTRAL_BODY_RADIUS;
+        single.DRAG_COEFFICIENT = params.DRAG_COEFFICIENT;
+        single.THRUST_COEFFICIENT = params.THRUST_COEFFICIENT;
+        single.DT = params.DT;
+        single.STEPS = params.STEPS;
+        single.ANALYTIC_KEPLER = false; //   4,     
+        single.initialState.x = initialBodies.x[0];
+        single.initialState.y = initialBodies.y[0];
+        single.initialState.vx = initialBodies.vx[0];
+        single.initialState.vy = initialBodies.vy[0];
+
+        Calculations calculator;
+        std::vector<State> states = calculator.runSimulation(single);
+        trajectory.time.reserve(states.size() / recordEvery + 2);
+        trajectory.x.reserve(states.size() / recordEvery + 2);
+        trajectory.y.reserve(states.size() / recordEvery + 2);
+        for (size_t i = 0; i < states.size(); ++i) {
+            if (i % recordEvery != 0 && i + 1 != states.size()) continue;
+            trajectory.time.push_back(i * params.DT);
+            trajectory.x.push_back(states[i].x);
+            trajectory.y.push_back(states[i].y);
+        }
+        if (!states.empty() && static_cast<int>(states.size()) - 1 < params.STEPS) {
+            trajectory.crashed[0] = 1; // Calculations    
+        }
+        return trajectory;
+    }
+
+    BodySystem bodies = initialBodies;
+    std::vector<unsigned char> active(n, 1);
+    Workspace ws(n, resolveThreadCount(params.THREADS));
+
+    trajectory.time.reserve(expectedSnapshots);
+    trajectory.x.reserve(expectedSnapshots * n);
+    trajectory.y.reserve(expectedSnapshots * n);
+    auto recordSnapshot = [&](double t) {
+        trajectory.time.push_back(t);
+        trajectory.x.insert(trajectory.x.end(), bodies.x.begin(), bodies.x.end());
+        trajectory.y.insert(trajectory.y.end(), bodies.y.begin(), bodies.y.end());
+    };
+
+    const double radiusSquared = params.CENTRAL_BODY_RADIUS * params.CENTRAL_BODY_RADIUS;
+    size_t activeCount = n;
+    auto detectCrashes = [&](int step) {
+        if (params.CENTRAL_MASS <= 0) return;
+        for (size_t i = 0; i < n; ++i) {
+            if (!active[i]) continue;
+            double r_squared = bodies.x[i] * bodies.x[i] + bodies.y[i] * bodies.y[i];
+            if (r_squared < radiusSquared) {
+                active[i] = 0;
+                trajectory.crashed[i] = 1;
+                --activeCount;
+                std::cout << "NBody:  " << i << "       " << step
+                    << ". : (" << bodies.x[i] << ", " << bodies.y[i] << ")\n";
+            }
+        }
+    };
+
+    detectCrashes(0);
+    recordSnapshot(0.0);
+
+    int lastRecordedStep = 0;
+    for (int i = 0; i < params.STEPS && activeCount > 0; ++i) {
+        rungeKuttaStep(bodies, active, params.DT, params, ws);
+        detectCrashes(i + 1);
+        if ((i + 1) % recordEvery == 0) {
+            recordSnapshot((i + 1) * params.DT);
+            lastRecordedStep = i + 1;
+        }
+        if (activeCount == 0 && lastRecordedStep != i + 1) {
+            recordSnapshot((i + 1) * params.DT); //    
+            lastRecordedStep = i + 1;
+        }
+    }
+    if (lastRecordedStep != params.STEPS && activeCount > 0 && params.STEPS > 0) {
+        recordSnapshot(params.STEPS * params.DT);
+    }
+    return trajectory;
+}
+
+void NBodyCalculations::computeMutualAccelerations(const double* x, const double* y, const std::vector<double>& mass,
+    const std::vector<unsigned char>& active, const NBodyParameters& params, Workspace& ws) {
+    if (mass.size() <= params.DIRECT_SUMMATION_MAX_BODIES) {
+        computeDirect(x, y, mass, active, params, ws);
+    }
+    else {
+        computeBarnesHut(x, y, mass, active, params, ws);
+    }
+}
+
+void NBodyCalculations::computeDirect(const double* x, const double* y, const std::vector<double>& mass,
+    const std::vector<unsigned char>& active, const NBodyParameters& params, Workspace& ws) {
+    const size_t n = mass.size();
+    const double softeningSquared = params.SOFTENING * params.SOFTENING;
+    const double G = params.G;
+    std::vector<double>& ax = ws.ax;
+    std::vector<double>& ay = ws.ay;
+
+    ws.pool.parallelFor(n, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            double sumX = 0.0, sumY = 0.0;
+            if (active[i]) {
+                const double xi = x[i], yi = y[i];
+                for (size_t j = 0; j < n; ++j) {
+                    if (j == i || !active[j] || mass[j] <= 0) continue;
+                    double dx = x[j] - xi;
+                    double dy = y[j] - yi;
+                    double distSquared = dx * dx + dy * dy + softeningSquared;
+                    double invDist = 1.0 / std::sqrt(distSquared);
+                    double factor = G * mass[j] * invDist * invDist * invDist;
+                    sumX += factor * dx;
+                    sumY += factor * dy;
+                }
+            }
+            ax[i] = sumX;
+            ay[i] = sumY;
+        }
+    });
+}
+
+void NBodyCalculations::computeBarnesHut(const double* x, const double* y, const std::vector<double>& mass,
+    const std::vector<unsigned char>& active, const NBodyParameters& params, Workspace& ws) {
+    const size_t n = mass.size();
+    std::vector<double>& ax = ws.ax;
+    std::vector<double>& ay = ws.ay;
+    const QuadTree& tree = ws.tree;
+    ws.tree.build(x, y, mass, active);
+
+    const double thetaSquared = params.THETA * params.THETA;
+    const double softeningSquared = params.SOFTENING * params.SOFTENING;
+
+    ws.pool.parallelFor(n, [&](size_t begin, size_t end) {
+        std::vector<int> stack; //      
+        stack.reserve(256);
+        for (size_t i = begin; i < end; ++i) {
+            if (!active[i]) { ax[i] = 0.0; ay[i] = 0.0; continue; }
+            tree.accelerationAt(x[i], y[i], static_cast<int>(i), thetaSquared, softeningSquared,
+                params.G, ax[i], ay[i], stack);
+        }
+    });
+}
+
+void NBodyCalculations::derivatives(const double* x, const double* y, const double* vx, const double* vy,
+    const std::vector<double>& mass, const std::vector<unsigned char>& active,
+    const NBodyParameters& params, Workspace& ws,
+    double* dx, double* dy, double* dvx, double* dvy) {
+    const size_t n = mass.size();
+    computeMutualAccelerations(x, y, mass, active, params, ws);
+
+    const double centralGM = params.G * params.CENTRAL_MASS;
+    const double net_propulsion_factor = params.THRUST_COEFFICIENT - params.DRAG_COEFFICIENT;
+    for (size_t i = 0; i < n; ++i) {
+        if (!active[i]) {
+            dx[i] = dy[i] = dvx[i] = dvy[i] = 0.0; //   
+            continue;
+        }
+        double ax = ws.ax[i] + net_propulsion_factor * vx[i];
+        double ay = ws.ay[i] + net_propulsion_factor * vy[i];
+        if (centralGM != 0.0) {
+            double r_squared = x[i] * x[i] + y[i] * y[i];
+            if (r_squared > 0) {
+                double r = std::sqrt(r_squared);
+                double common_factor_gravity = -centralGM / (r_squared * r);
+                ax += common_factor_gravity * x[i];
+                ay += common_factor_gravity * y[i];
+            }
+        }
+        dx[i] = vx[i];
+        dy[i] = vy[i];
+        dvx[i] = ax;
+        dvy[i] = ay;
+    }
+}
+
+void NBodyCalculations::rungeKuttaStep(BodySystem& bodies, const std::vector<unsigned char>& active,
+    double dt, const NBodyParameters& params, Workspace& ws) {
+    const size_t n = bodies.size();
+    double* x = bodies.x.data();
+    double* y = bodies.y.data();
+    double* vx = bodies.vx.data();
+    double* vy = bodies.vy.data();
+
+    derivatives(x, y, vx, vy, bodies.mass, active, params, ws,
+        ws.kx[0].data(), ws.ky[0].data(), ws.kvx[0].data(), ws.kvy[0].data());
+
+    //  2-4:  s + c * dt * k[]
+    const double stageFactor[3] = { dt / 2.0, dt / 2.0, dt };
+    for (int stage = 1; stage < 4; ++stage) {
+        const double h = stageFactor[stage - 1];
+        const double* kx = ws.kx[stage - 1].data();
+        const double* ky = ws.ky[stage - 1].data();
+        const double* kvx = ws.kvx[stage - 1].data();
+        const double* kvy = ws.kvy[stage - 1].data();
+        for (size_t i = 0; i < n; ++i) {
+            ws.sx[i] = x[i] + h * kx[i];
+            ws.sy[i] = y[i] + h * ky[i];
+            ws.svx[i] = vx[i] + h * kvx[i];
+            ws.svy[i] = vy[i] + h * kvy[i];
+        }
+        derivatives(ws.sx.data(), ws.sy.data(), ws.svx.data(), ws.svy.data(), bodies.mass, active, params, ws,
+            ws.kx[stage].data(), ws.ky[stage].data(), ws.kvx[stage].data(), ws.kvy[stage].data());
+    }
+
+    const double w = dt / 6.0;
+    for (size_t i = 0; i < n; ++i) {
+        x[i] += w * (ws.kx[0][i] + 2.0 * ws.kx[1][i] + 2.0 * ws.kx[2][i] + ws.kx[3][i]);
+        y[i] += w * (ws.ky[0][i] + 2.0 * ws.ky[1][i] + 2.0 * ws.ky[2][i] + ws.ky[3][i]);
+        vx[i] += w * (ws.kvx[0][i] + 2.0 * ws.kvx[1][i] + 2.0 * ws.kvx[2][i] + ws.kvx[3][i]);
+        vy[i] += w * (ws.kvy[0][i] + 2.0 * ws.kvy[1][i] + 2.0 * ws.kvy[2][i] + ws.kvy[3][i]);
+    }
+}
@@ -0,0 +1,92 @@
+#ifndef NBODYCALCULATIONS_H
+#define NBODYCALCULATIONS_H
+
+#include <vector>
+#include <cstddef>
+#include <string>
+
+#include "Calculations.h" // SimulationParameters  State      
+
+//  N    SoA (structure of arrays):   
+//    ,      .
+struct BodySystem {
+    std::vector<double> x, y;
+    std::vector<double> vx, vy;
+    std::vector<double> mass; //  0 -   (  )
+
+    size_t size() const { return x.size(); }
+    void addBody(double bx, double by, double bvx, double bvy, double bodyMass);
+    void reserve(size_t count);
+};
+
+//  N-  ( ,    SimulationParameters)
+struct NBodyParameters {
+    double G = 1.0;
+    //       ( M   ).
+    // 0 -   ,   .
+    double CENTRAL_MASS = 1.0;
+    double CENTRAL_BODY_RADIUS = 0.01;
+    double DRAG_COEFFICIENT = 0.0;
+    double THRUST_COEFFICIENT = 0.0;
+    double DT = 0.001;
+    int STEPS = 100000;
+
+    double SOFTENING = 1e-4;   //  ,     
+    double THETA = 0.5;        //    Barnes-Hut (size / distance < THETA)
+    size_t DIRECT_SUMMATION_MAX_BODIES = 256; //   N     O(N^2)
+    unsigned int THREADS = 0;  // 0 -    
+    int RECORD_EVERY = 1;      //     RECORD_EVERY- 
+};
+
+// :       .
+//  s,  b: x[s * bodyCount + b].
+struct NBodyTrajectory {
+    size_t bodyCount = 0;
+    std::vector<double> time;
+    std::vector<double> x, y;
+    std::vector<unsigned char> crashed; // 1 -      (  )
+
+    size_t snapshotCount() const { return time.size(); }
+};
+
+class NBodyCalculations {
+public:
+    NBodyCalculations();
+
+    //     N- .
+    //        Calculations::runSimulation.
+    NBodyTrajectory runSimulation(const BodySystem& initialBodies, const NBodyParameters& params);
+
+    //  "  +  ",   
+    static BodySystem fromSingleSatellite(const SimulationParameters& params);
+
+    //    :   "x y vx vy mass"  , '#' -    .
+    // false -        (    cerr).
+    static bool loadBodies(const std::string& path, BodySystem& bodies);
+
+private:
+    struct Workspace; //    4,   
+
+    //      (    )
+    //  -  ws.ax, ws.ay;  -  ws.pool
+    static void computeMutualAccelerations(const double* x, const double* y, const std::vector<double>& mass,
+        const std::vector<unsigned char>& active, const NBodyParameters& params, Workspace& ws);
+
+    static void computeDirect(const double* x, const double* y, const std::vector<double>& mass,
+        const std::vector<unsigned char>& active, const NBodyParameters& params, Workspace& ws);
+
+    static void computeBarnesHut(const double* x, const double* y, const std::vector<double>& mass,
+        const std::vector<unsigned char>& active, const NBodyParameters& params, Workspace& ws);
+
+    //        
+    static void derivatives(const double* x, const double* y, const double* vx, const double* vy,
+        const std::vector<double>& mass, const std::vector<unsigned char>& active,
+        const NBodyParameters& params, Workspace& ws,
+        double* dx, double* dy, double* dvx, double* dvy);
+
+    //   4    ( )
+    static void rungeKuttaStep(BodySystem& bodies, const std::vector<unsigned char>& active,
+        double dt, const NBodyParameters& params, Workspace& ws);
+};
+
+#endif // NBODYCALCULATIONS_H
@@ -0,0 +1,143 @@
+#include "OrbitAnalytics.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+double specificEnergy(const State& s, double mu) {
+    return 0.5 * (s.vx * s.vx + s.vy * s.vy) - mu / std::sqrt(s.x * s.x + s.y * s.y);
+}
+
+double eccentricity(const State& s, double mu) {
+    const double r = std::sqrt(s.x * s.x + s.y * s.y);
+    const double v2 = s.vx * s.vx + s.vy * s.vy;
+    const double rv = s.x * s.vx + s.y * s.vy;
+    // e = ((v^2 - mu/r) r - (r.v) v) / mu
+    const double ex = ((v2 - mu / r) * s.x - rv * s.vx) / mu;
+    const double ey = ((v2 - mu / r) * s.y - rv * s.vy) / mu;
+    return std::sqrt(ex * ex + ey * ey);
+}
+}
+
+OrbitAnalytics::OrbitAnalytics() {
+    reset(SimulationParameters());
+}
+
+void OrbitAnalytics::reset(const SimulationParameters& params) {
+    m_mu = params.G * params.M;
+    m_dt = params.DT;
+    m_samples = 0;
+    m_first = m_last = State{ 0.0, 0.0, 0.0, 0.0 };
+    m_lastRadius = m_lastRadialVelocity = 0.0;
+    m_energyInitial = m_energyLast = m_maxEnergyDrift = 0.0;
+    m_minRadius = m_maxRadius = 0.0;
+    m_periapsis = m_apoapsis = 0.0;
+    m_rayX = 1.0;
+    m_rayY = 0.0;
+    m_direction = 1.0;
+    m_lastSide = 0.0;
+    m_crossings = 0;
+    m_firstCrossingTime = m_previousCrossingTime = m_lastCrossingTime = 0.0;
+    m_axisSamples = 0;
+    m_meanTime = m_meanAxis = m_timeVariance = m_covariance = 0.0;
+}
+
+void OrbitAnalytics::addState(const State& state) {
+    const double t = static_cast<double>(m_samples) * m_dt;
+    const double r = std::sqrt(state.x * state.x + state.y * state.y);
+    const double radialVelocity = state.x * state.vx + state.y * state.vy; // r * dr/dt
+    const double energy = 0.5 * (state.vx * state.vx + state.vy * state.vy) - m_mu / r;
+
+    if (m_samples == 0) {
+        m_first = state;
+        m_energyInitial = energy;
+        m_minRadius = m_maxRadius = r;
+        //    .   -    
+        m_direction = (state.x * state.vy - state.y * state.vx) < 0.0 ? -1.0 : 1.0;
+        if (r > 0.0) {
+            m_rayX = state.x / r;
+            m_rayY = state.y / r;
+        }
+        m_crossings = 1; //     
+    }
+    else {
+        m_minRadius = std::min(m_minRadius, r);
+        m_maxRadius = std::max(m_maxRadius, r);
+        if (m_energyInitial != 0.0) {
+            m_maxEnergyDrift = std::max(m_maxEnergyDrift, std::abs((energy - m_energyInitial) / m_energyInitial));
+        }
+
+        //  r:    ,   ()    
+        if (m_lastRadialVelocity > 0.0 && radialVelocity <= 0.0) m_apoapsis = std::max(m_lastRadius, r);
+        if (m_lastRadialVelocity < 0.0 && radialVelocity >= 0.0) m_periapsis = std::min(m_lastRadius, r);
+
+        //  :    ""  "",     ,     
+        const double side = m_direction * (m_rayX * state.y - m_rayY * state.x);
+        const double along = m_rayX * state.x + m_rayY * state.y;
+        if (m_lastSide < 0.0 && side >= 0.0 && along > 0.0) {
+            const double crossingTime = t - m_dt * side / (side - m_lastSide);
+            m_previousCrossingTime = m_lastCrossingTime;
+            m_lastCrossingTime = crossingTime;
+            ++m_crossings;
+        }
+        m_lastSide = side;
+    }
+
+    if (energy < 0.0) {
+        //   ,    
+        const double axis = -m_mu / (2.0 * energy);
+        ++m_axisSamples;
+        const double dTime = t - m_meanTime;
+        m_meanTime += dTime / static_cast<double>(m_axisSamples);
+        m_meanAxis += (axis - m_meanAxis) / static_cast<double>(m_axisSamples);
+        m_timeVariance += dTime * (t - m_meanTime);
+        m_covariance += dTime * (axis - m_meanAxis);
+    }
+
+    m_last = state;
+    m_lastRadius = r;
+    m_lastRadialVelocity = radialVelocity;
+    m_energyLast = energy;
+    ++m_samples;
+}
+
+OrbitAnalytics::Summary OrbitAnalytics::getSummary() const {
+    Summary summary;
+    summary.samples = m_samples;
+    if (m_samples == 0) return summary;
+
+    summary.duration = static_cast<double>(m_samples - 1) * m_dt;
+    summary.bound = m_energyLast < 0.0;
+    summary.orbits = m_crossings - 1;
+    if (summary.orbits > 0) {
+        summary.period = (m_lastCrossingTime - m_firstCrossingTime) / summary.orbits;
+        summary.lastPeriod = m_lastCrossingTime - (summary.orbits > 1 ? m_previousCrossingTime : m_firstCrossingTime);
+    }
+    summary.eccentricityInitial = eccentricity(m_first, m_mu);
+    summary.eccentricityFinal = eccentricity(m_last, m_mu);
+    summary.periapsis = m_periapsis;
+    summary.apoapsis = m_apoapsis;
+    summary.minRadius = m_minRadius;
+    summary.maxRadius = m_maxRadius;
+    summary.energyInitial = specificEnergy(m_first, m_mu);
+    summary.energyFinal = m_energyLast;
+    summary.maxRelativeEnergyDrift = m_maxEnergyDrift;
+    if (m_axisSamples >= 2 && m_timeVariance > 0.0) {
+        summary.semiMajorAxisRate = m_covariance / m_timeVariance;
+    }
+    return summary;
+}
+
+void OrbitAnalytics::printSummary(std::ostream& out) const {
+    const Summary s = getSummary();
+    out << "OrbitAnalytics: " << s.samples << " , t = " << s.duration << "\n";
+    out << "  : " << s.orbits;
+    if (s.orbits > 0) out << ",  " << s.period << " ( " << s.lastPeriod << ")";
+    out << "\n";
+    out << "  : " << s.eccentricityInitial << " -> " << s.eccentricityFinal << "\n";
+    out << "   " << s.periapsis << ",  " << s.apoapsis
+        << " (r  " << s.minRadius << "  " << s.maxRadius << ")\n";
+    out << "  : " << s.energyInitial << " -> " << s.energyFinal
+        << ", . .  " << s.maxRelativeEnergyDrift << (s.bound ? "" : " ( )") << "\n";
+    out << "  da/dt = " << s.semiMajorAxisRate << "\n";
+}
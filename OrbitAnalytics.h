@@ -0,0 +1,76 @@
+#ifndef ORBITANALYTICS_H
+#define ORBITANALYTICS_H
+
+#include <cstddef>
+#include <ostream>
+
+#include "Calculations.h"
+
+//  ,          O(1) :
+//     (addState)    , 
+//    .    ,     
+// (ChunkedTrajectoryWriter::writeSimulation).
+//
+//  -         ( 
+//     ),    -   
+//  ,   -       .
+class OrbitAnalytics {
+public:
+    struct Summary {
+        size_t samples = 0;
+        double duration = 0.0;        //    ()
+        bool bound = false;           //     
+        int orbits = 0;               //   (   )
+        double period = 0.0;          //  , 0   
+        double lastPeriod = 0.0;      //   
+        double eccentricityInitial = 0.0;
+        double eccentricityFinal = 0.0;
+        double periapsis = 0.0;       //   , 0   
+        double apoapsis = 0.0;        //   , 0   
+        double minRadius = 0.0;
+        double maxRadius = 0.0;
+        double energyInitial = 0.0;
+        double energyFinal = 0.0;
+        double maxRelativeEnergyDrift = 0.0; // max |E - E0| / |E0|
+        double semiMajorAxisRate = 0.0;      // da/dt, < 0 -  ; 0   
+    };
+
+    OrbitAnalytics();
+
+    //   : G, M  DT   params
+    void reset(const SimulationParameters& params);
+    void addState(const State& state);
+    size_t getSampleCount() const { return m_samples; }
+
+    Summary getSummary() const;
+    void printSummary(std::ostream& out) const;
+
+private:
+    double m_mu;
+    double m_dt;
+    size_t m_samples;
+
+    //    
+    State m_first;
+    State m_last;
+    double m_lastRadius;
+    double m_lastRadialVelocity;
+    double m_energyInitial;
+    double m_energyLast;
+    double m_maxEnergyDrift;
+    double m_minRadius, m_maxRadius;
+    double m_periapsis, m_apoapsis;
+
+    //     
+    double m_rayX, m_rayY;  //   
+    double m_direction;     // +1 -    , -1 -  
+    double m_lastSide;      // > 0 -       
+    int m_crossings;
+    double m_firstCrossingTime, m_previousCrossingTime, m_lastCrossingTime;
+
+    //     a(t) (- )
+    size_t m_axisSamples;
+    double m_meanTime, m_meanAxis, m_timeVariance, m_covariance;
+};
+
+#endif // ORBITANALYTICS_H
@@ -0,0 +1,206 @@
+#include "PararealCalculations.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <thread>
+
+namespace {
+
+unsigned int resolveThreadCount(unsigned int requested) {
+    if (requested > 0) return requested;
+    unsigned int hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+//   [begin, end)   :    
+//   ,      
+template <typename Fn>
+void parallelForEach(size_t begin, size_t end, unsigned int threadCount, Fn fn) {
+    std::atomic<size_t> next(begin);
+    auto worker = [&]() {
+        for (size_t i = next++; i < end; i = next++) fn(i);
+    };
+    size_t workerCount = std::min<size_t>(threadCount, end > begin ? end - begin : 0);
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < workerCount; ++t) workers.emplace_back(worker);
+    worker(); //    
+    for (auto& w : workers) w.join();
+}
+
+double stateDifference(const State& a, const State& b) {
+    double diff = std::max(std::max(std::abs(a.x - b.x), std::abs(a.y - b.y)),
+        std::max(std::abs(a.vx - b.vx), std::abs(a.vy - b.vy)));
+    //    ""     inf/NaN -    
+    return std::isfinite(diff) ? diff : std::numeric_limits<double>::infinity();
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+PararealCalculations::PararealCalculations() {
+}
+
+State PararealCalculations::coarsePropagate(const State& start, int steps, const SimulationParameters& params,
+    int coarseStepRatio) {
+    int coarseSteps = std::max(1, steps / std::max(1, coarseStepRatio));
+    double dt = params.DT * steps / coarseSteps;
+    State s = start;
+    for (int i = 0; i < coarseSteps; ++i) {
+        s = Calculations::rungeKuttaStep(s, dt, params);
+    }
+    return s;
+}
+
+int PararealCalculations::finePropagate(const State& start, int firstStep, int lastStep,
+    const SimulationParameters& params, std::vector<State>& trajectoryStates) {
+    const double radiusSquared = params.CENTRAL_BODY_RADIUS * params.CENTRAL_BODY_RADIUS;
+    State s = start;
+    for (int i = firstStep; i < lastStep; ++i) {
+        s = Calculations::rungeKuttaStep(s, params.DT, params);
+        trajectoryStates[static_cast<size_t>(i) + 1] = s;
+        if (s.x * s.x + s.y * s.y < radiusSquared) return i + 1;
+    }
+    return -1;
+}
+
+PararealReport PararealCalculations::runSimulation(const SimulationParameters& params,
+    const PararealParameters& pararealParams, std::vector<State>& trajectoryStates) {
+    PararealReport report;
+    const auto startTime = std::chrono::steady_clock::now();
+    const int totalSteps = std::max(0, params.STEPS);
+    const unsigned int threadCount = resolveThreadCount(pararealParams.THREADS);
+    if (params.PRECISION != Precision::Double) {
+        std::cerr << "Parareal:   (" << Calculations::precisionName(params.PRECISION)
+            << ")  ,    double\n";
+    }
+
+    State initial;
+    initial.x = params.initialState.x;
+    initial.y = params.initialState.y;
+    initial.vx = params.initialState.vx;
+    initial.vy = params.initialState.vy;
+
+    trajectoryStates.clear();
+    trajectoryStates.resize(static_cast<size_t>(totalSteps) + 1);
+    trajectoryStates[0] = initial;
+
+    //   ,  ;      -   Calculations
+    unsigned int sliceCount = pararealParams.SLICES > 0 ? pararealParams.SLICES : threadCount;
+    sliceCount = static_cast<unsigned int>(std::min<long long>(sliceCount, std::max(1, totalSteps)));
+    report.slices = sliceCount;
+    if (totalSteps == 0 ||
+        initial.x * initial.x + initial.y * initial.y < params.CENTRAL_BODY_RADIUS * params.CENTRAL_BODY_RADIUS) {
+        trajectoryStates.resize(1);
+        report.converged = true;
+        report.pararealSeconds = secondsSince(startTime);
+        return report;
+    }
+
+    //  k:  sliceBegin[k]..sliceBegin[k + 1]
+    std::vector<int> sliceBegin(sliceCount + 1);
+    for (unsigned int k = 0; k <= sliceCount; ++k) {
+        sliceBegin[k] = static_cast<int>(static_cast<long long>(totalSteps) * k / sliceCount);
+    }
+
+    std::vector<State> start(sliceCount + 1);      // U[k] -   
+    std::vector<State> coarse(sliceCount);         // G(U[k])   
+    std::vector<State> fine(sliceCount);           // F(U[k])
+    std::vector<int> collisionStep(sliceCount, -1);
+    start[0] = initial;
+    for (unsigned int k = 0; k < sliceCount; ++k) {
+        coarse[k] = coarsePropagate(start[k], sliceBegin[k + 1] - sliceBegin[k], params, pararealParams.COARSE_STEP_RATIO);
+        start[k + 1] = coarse[k];
+    }
+
+    const int maxIterations = pararealParams.MAX_ITERATIONS > 0
+        ? std::min<int>(pararealParams.MAX_ITERATIONS, sliceCount) : static_cast<int>(sliceCount);
+    int finalLength = totalSteps + 1;
+
+    for (int iteration = 0; iteration < maxIterations; ++iteration) {
+        //   iteration       
+        const unsigned int firstInexact = static_cast<unsigned int>(iteration);
+        parallelForEach(firstInexact, sliceCount, threadCount, [&](size_t k) {
+            collisionStep[k] = finePropagate(start[k], sliceBegin[k], sliceBegin[k + 1], params, trajectoryStates);
+            fine[k] = trajectoryStates[static_cast<size_t>(collisionStep[k] >= 0 ? collisionStep[k] : sliceBegin[k + 1])];
+        });
+        report.iterations = iteration + 1;
+
+        //        -   
+        unsigned int lastRelevantSlice = sliceCount - 1;
+        for (unsigned int k = 0; k < sliceCount; ++k) {
+            if (collisionStep[k] >= 0) { lastRelevantSlice = k; break; }
+        }
+        if (lastRelevantSlice <= firstInexact || iteration + 1 == static_cast<int>(sliceCount)) {
+            report.converged = true; //       
+            break;
+        }
+
+        double maxCorrection = 0.0;
+        for (unsigned int k = firstInexact; k < lastRelevantSlice; ++k) {
+            State predicted = coarsePropagate(start[k], sliceBegin[k + 1] - sliceBegin[k], params, pararealParams.COARSE_STEP_RATIO);
+            State corrected = {
+                predicted.x + fine[k].x - coarse[k].x,
+                predicted.y + fine[k].y - coarse[k].y,
+                predicted.vx + fine[k].vx - coarse[k].vx,
+                predicted.vy + fine[k].vy - coarse[k].vy
+            };
+            coarse[k] = predicted;
+            maxCorrection = std::max(maxCorrection, stateDifference(corrected, start[k + 1]));
+            start[k + 1] = corrected;
+        }
+        if (maxCorrection < pararealParams.TOLERANCE) {
+            //     ,       TOLERANCE
+            report.converged = true;
+            break;
+        }
+    }
+
+    for (unsigned int k = 0; k < sliceCount; ++k) {
+        if (collisionStep[k] >= 0) {
+            finalLength = collisionStep[k] + 1;
+            std::cout << "Parareal:     " << collisionStep[k] << "\n";
+            break;
+        }
+    }
+    trajectoryStates.resize(static_cast<size_t>(finalLength));
+    report.pararealSeconds = secondsSince(startTime);
+
+    if (pararealParams.COMPARE_WITH_SERIAL) {
+        const auto serialStart = std::chrono::steady_clock::now();
+        Calculations calculator;
+        std::vector<State> serialStates;
+        //        4,        
+        SimulationParameters serialParams = params;
+        serialParams.ANALYTIC_KEPLER = false;
+        calculator.runSimulation(serialParams, serialStates);
+        report.serialSeconds = secondsSince(serialStart);
+        report.speedup = report.pararealSeconds > 0.0 ? report.serialSeconds / report.pararealSeconds : 0.0;
+
+        size_t common = std::min(serialStates.size(), trajectoryStates.size());
+        for (size_t i = 0; i < common; ++i) {
+            double dx = trajectoryStates[i].x - serialStates[i].x;
+            double dy = trajectoryStates[i].y - serialStates[i].y;
+            report.maxPositionError = std::max(report.maxPositionError, std::sqrt(dx * dx + dy * dy));
+        }
+        if (serialStates.size() != trajectoryStates.size()) {
+            std::cerr << "Parareal:   (" << trajectoryStates.size()
+                << ")     (" << serialStates.size() << ")\n";
+        }
+    }
+
+    std::cout << "Parareal:  " << report.slices << ",  " << report.iterations
+        << (report.converged ? "" : " ( )") << ",  " << report.pararealSeconds << " ";
+    if (pararealParams.COMPARE_WITH_SERIAL) {
+        std::cout << ",  " << report.serialSeconds << " ,  " << report.speedup
+            << ", .   " << report.maxPositionError;
+    }
+    std::cout << "\n";
+    return report;
+}
@@ -0,0 +1,53 @@
+#ifndef PARAREALCALCULATIONS_H
+#define PARAREALCALCULATIONS_H
+
+#include <vector>
+
+#include "Calculations.h"
+
+//    Parareal (  )
+struct PararealParameters {
+    unsigned int SLICES = 0;       //   . 0 -   
+    unsigned int THREADS = 0;      // 0 -    
+    int COARSE_STEP_RATIO = 100;   //    = DT * COARSE_STEP_RATIO
+    int MAX_ITERATIONS = 0;        // 0 -     (   )
+    double TOLERANCE = 1e-9;       // :  ||  x, y, vx, vy   
+    bool COMPARE_WITH_SERIAL = true; //       
+};
+
+//   Parareal
+struct PararealReport {
+    unsigned int slices = 0;
+    int iterations = 0;
+    bool converged = false;
+    double pararealSeconds = 0.0;
+    double serialSeconds = 0.0;     // 0,      
+    double speedup = 0.0;
+    double maxPositionError = 0.0;  //      
+};
+
+// Parareal:     ,  4    
+//    ,   4   DT    .
+//    :
+//     U[k+1] = G(U_new[k]) + F(U_old[k]) - G(U_old[k]),
+//      TOLERANCE.  j   j  ,
+//     (SLICES )    .
+class PararealCalculations {
+public:
+    PararealCalculations();
+
+    //    trajectoryStates    ,    Calculations::runSimulation
+    PararealReport runSimulation(const SimulationParameters& params, const PararealParameters& pararealParams,
+        std::vector<State>& trajectoryStates);
+
+private:
+    //  : steps  DT,   DT * COARSE_STEP_RATIO
+    static State coarsePropagate(const State& start, int steps, const SimulationParameters& params, int coarseStepRatio);
+
+    //  :  firstStep+1..lastStep   trajectoryStates   .
+    //         -1.
+    static int finePropagate(const State& start, int firstStep, int lastStep, const SimulationParameters& params,
+        std::vector<State>& trajectoryStates);
+};
+
+#endif // PARAREALCALCULATIONS_H
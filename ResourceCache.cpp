@@ -0,0 +1,81 @@
+#include "ResourceCache.h"
+
+#include <iostream>
+
+ResourceCache& ResourceCache::instance() {
+    //    :   SFML      ,
+    //        .   clear().
+    static ResourceCache* cache = new ResourceCache();
+    return *cache;
+}
+
+std::shared_ptr<const sf::Font> ResourceCache::font(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_fonts.find(path);
+    if (it != m_fonts.end()) return it->second;
+
+    std::shared_ptr<sf::Font> loaded(new sf::Font());
+    if (!loaded->loadFromFile(path)) {
+        std::cerr << "ResourceCache:     " << path << "\n";
+        loaded.reset();
+    }
+    m_fonts.emplace(path, loaded);
+    return loaded;
+}
+
+std::shared_ptr<const sf::Texture> ResourceCache::texture(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_textures.find(path);
+    if (it != m_textures.end()) return it->second;
+
+    std::shared_ptr<sf::Texture> loaded(new sf::Texture());
+    if (!loaded->loadFromFile(path)) {
+        std::cerr << "ResourceCache:     " << path << "\n";
+        loaded.reset();
+    }
+    m_textures.emplace(path, loaded);
+    return loaded;
+}
+
+std::unique_ptr<sf::RenderWindow> ResourceCache::acquireWindow(unsigned int width, unsigned int height, const std::string& title) {
+    std::unique_ptr<sf::RenderWindow> window;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_windowPool.empty()) {
+            window = std::move(m_windowPool.back());
+            m_windowPool.pop_back();
+        }
+    }
+
+    if (window && window->isOpen()) {
+        window->setSize(sf::Vector2u(width, height));
+        window->setTitle(title);
+        window->setView(sf::View(sf::FloatRect(0.f, 0.f, static_cast<float>(width), static_cast<float>(height))));
+        window->setVisible(true);
+        window->requestFocus();
+        return window;
+    }
+    return std::unique_ptr<sf::RenderWindow>(
+        new sf::RenderWindow(sf::VideoMode(width, height), title, sf::Style::Default));
+}
+
+void ResourceCache::releaseWindow(std::unique_ptr<sf::RenderWindow> window) {
+    if (!window || !window->isOpen()) return;
+    window->setVisible(false);
+    // ,    (, ),     
+    sf::Event event{};
+    while (window->pollEvent(event)) {
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_windowPool.size() < WINDOW_POOL_SIZE) {
+        m_windowPool.push_back(std::move(window));
+    }
+}
+
+void ResourceCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_windowPool.clear();
+    m_textures.clear();
+    m_fonts.clear();
+}
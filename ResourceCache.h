@@ -0,0 +1,42 @@
+#ifndef RESOURCECACHE_H
+#define RESOURCECACHE_H
+
+#include <SFML/Graphics.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//      : ,    .
+//         ,      .
+//     (nullptr),         .
+class ResourceCache {
+public:
+    static ResourceCache& instance();
+
+    std::shared_ptr<const sf::Font> font(const std::string& path);
+    std::shared_ptr<const sf::Texture> texture(const std::string& path);
+
+    //    (   ).     ,
+    //  ,          OpenGL-.
+    //  (close())     .
+    std::unique_ptr<sf::RenderWindow> acquireWindow(unsigned int width, unsigned int height, const std::string& title);
+    void releaseWindow(std::unique_ptr<sf::RenderWindow> window);
+
+    //      .     main,  SFML
+    //      ;   shared_ptr  .
+    void clear();
+
+private:
+    static constexpr size_t WINDOW_POOL_SIZE = 1; //    
+
+    ResourceCache() = default;
+
+    std::mutex m_mutex;
+    std::map<std::string, std::shared_ptr<const sf::Font>> m_fonts;
+    std::map<std::string, std::shared_ptr<const sf::Texture>> m_textures;
+    std::vector<std::unique_ptr<sf::RenderWindow>> m_windowPool;
+};
+
+#endif // RESOURCECACHE_H
@@ -0,0 +1,187 @@
+#include "ScreenProjection.h"
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SCREENPROJECTION_USE_SSE2 1
+#endif
+
+namespace {
+
+unsigned int resolveThreadCount() {
+    unsigned int hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+//  [0, count)  ,  4 ( SIMD-  ),     .
+// fn(chunkIndex, begin, end);   .
+template <typename Fn>
+size_t parallelChunks(size_t count, bool parallel, Fn fn) {
+    size_t chunks = parallel ? std::min<size_t>(resolveThreadCount(), count / 4 + 1) : 1;
+    size_t chunkSize = ((count + chunks - 1) / chunks + 3) & ~size_t(3);
+    std::vector<std::thread> workers;
+    for (size_t c = 1; c < chunks; ++c) {
+        size_t begin = c * chunkSize;
+        size_t end = std::min(count, begin + chunkSize);
+        if (begin >= end) break;
+        workers.emplace_back([=]() { fn(c, begin, end); });
+    }
+    fn(size_t(0), size_t(0), std::min(count, chunkSize)); //     
+    for (auto& worker : workers) worker.join();
+    return chunks;
+}
+
+PointBounds emptyBounds() {
+    const float inf = std::numeric_limits<float>::infinity();
+    return { inf, -inf, inf, -inf };
+}
+
+PointBounds mergeBounds(const PointBounds& a, const PointBounds& b) {
+    return { std::min(a.minX, b.minX), std::max(a.maxX, b.maxX), std::min(a.minY, b.minY), std::max(a.maxY, b.maxY) };
+}
+
+void projectRange(const float* wx, const float* wy, size_t begin, size_t end,
+    float originX, float originY, float scale, const sf::Color& color, sf::Vertex* out) {
+    size_t i = begin;
+#ifdef SCREENPROJECTION_USE_SSE2
+    const __m128 ox = _mm_set1_ps(originX);
+    const __m128 oy = _mm_set1_ps(originY);
+    const __m128 sc = _mm_set1_ps(scale);
+    alignas(16) float sx[4], sy[4];
+    for (; i + 4 <= end; i += 4) {
+        _mm_store_ps(sx, _mm_add_ps(ox, _mm_mul_ps(_mm_loadu_ps(wx + i), sc)));
+        _mm_store_ps(sy, _mm_sub_ps(oy, _mm_mul_ps(_mm_loadu_ps(wy + i), sc)));
+        for (int j = 0; j < 4; ++j) {
+            out[i + j].position.x = sx[j];
+            out[i + j].position.y = sy[j];
+            out[i + j].color = color;
+        }
+    }
+#endif
+    for (; i < end; ++i) {
+        out[i].position.x = originX + wx[i] * scale;
+        out[i].position.y = originY - wy[i] * scale;
+        out[i].color = color;
+    }
+}
+
+PointBounds boundsRange(const float* x, const float* y, size_t begin, size_t end) {
+    PointBounds bounds = emptyBounds();
+    size_t i = begin;
+#ifdef SCREENPROJECTION_USE_SSE2
+    if (end - begin >= 4) {
+        __m128 minX = _mm_set1_ps(bounds.minX), maxX = _mm_set1_ps(bounds.maxX);
+        __m128 minY = _mm_set1_ps(bounds.minY), maxY = _mm_set1_ps(bounds.maxY);
+        for (; i + 4 <= end; i += 4) {
+            __m128 vx = _mm_loadu_ps(x + i);
+            __m128 vy = _mm_loadu_ps(y + i);
+            minX = _mm_min_ps(minX, vx); maxX = _mm_max_ps(maxX, vx);
+            minY = _mm_min_ps(minY, vy); maxY = _mm_max_ps(maxY, vy);
+        }
+        alignas(16) float lanes[4][4];
+        _mm_store_ps(lanes[0], minX); _mm_store_ps(lanes[1], maxX);
+        _mm_store_ps(lanes[2], minY); _mm_store_ps(lanes[3], maxY);
+        for (int j = 0; j < 4; ++j) {
+            bounds.minX = std::min(bounds.minX, lanes[0][j]); bounds.maxX = std::max(bounds.maxX, lanes[1][j]);
+            bounds.minY = std::min(bounds.minY, lanes[2][j]); bounds.maxY = std::max(bounds.maxY, lanes[3][j]);
+        }
+    }
+#endif
+    for (; i < end; ++i) {
+        bounds.minX = std::min(bounds.minX, x[i]); bounds.maxX = std::max(bounds.maxX, x[i]);
+        bounds.minY = std::min(bounds.minY, y[i]); bounds.maxY = std::max(bounds.maxY, y[i]);
+    }
+    return bounds;
+}
+
+void densityRange(const float* wx, const float* wy, size_t begin, size_t end,
+    float originX, float originY, float scale, unsigned int width, unsigned int height, uint32_t* grid) {
+    const float maxX = static_cast<float>(width);
+    const float maxY = static_cast<float>(height);
+    for (size_t i = begin; i < end; ++i) {
+        float sx = originX + wx[i] * scale;
+        float sy = originY - wy[i] * scale;
+        if (sx >= 0.f && sx < maxX && sy >= 0.f && sy < maxY) {
+            ++grid[static_cast<size_t>(sy) * width + static_cast<size_t>(sx)];
+        }
+    }
+}
+
+}
+
+void ScreenProjection::project(const WorldPointsSoA& world, float originX, float originY, float scale,
+    const sf::Color& color, sf::Vertex* out) {
+    const size_t count = world.size();
+    if (count == 0) return;
+    const float* wx = world.x.data();
+    const float* wy = world.y.data();
+    parallelChunks(count, count >= PARALLEL_MIN_POINTS, [&](size_t, size_t begin, size_t end) {
+        projectRange(wx, wy, begin, end, originX, originY, scale, color, out);
+    });
+}
+
+PointBounds ScreenProjection::computeBounds(const float* x, const float* y, size_t count) {
+    std::vector<PointBounds> partial(count >= PARALLEL_MIN_POINTS ? resolveThreadCount() : 1, emptyBounds());
+    parallelChunks(count, count >= PARALLEL_MIN_POINTS, [&](size_t chunk, size_t begin, size_t end) {
+        partial[chunk] = boundsRange(x, y, begin, end);
+    });
+    PointBounds bounds = emptyBounds();
+    for (const auto& part : partial) bounds = mergeBounds(bounds, part);
+    return bounds;
+}
+
+PointBounds ScreenProjection::computeBounds(const WorldPointsSoA& points) {
+    return computeBounds(points.x.data(), points.y.data(), points.size());
+}
+
+PointBounds ScreenProjection::computeBounds(const sf::Vertex* vertices, size_t count) {
+    std::vector<PointBounds> partial(count >= PARALLEL_MIN_POINTS ? resolveThreadCount() : 1, emptyBounds());
+    parallelChunks(count, count >= PARALLEL_MIN_POINTS, [&](size_t chunk, size_t begin, size_t end) {
+        PointBounds bounds = emptyBounds();
+        for (size_t i = begin; i < end; ++i) {
+            const sf::Vector2f& p = vertices[i].position;
+            bounds.minX = std::min(bounds.minX, p.x); bounds.maxX = std::max(bounds.maxX, p.x);
+            bounds.minY = std::min(bounds.minY, p.y); bounds.maxY = std::max(bounds.maxY, p.y);
+        }
+        partial[chunk] = bounds;
+    });
+    PointBounds bounds = emptyBounds();
+    for (const auto& part : partial) bounds = mergeBounds(bounds, part);
+    return bounds;
+}
+
+void ScreenProjection::accumulateDensity(const WorldPointsSoA& world, size_t begin, size_t end,
+    float originX, float originY, float scale, unsigned int width, unsigned int height,
+    std::vector<uint32_t>& grid) {
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    if (grid.size() != pixelCount) grid.assign(pixelCount, 0);
+    end = std::min(end, world.size());
+    if (begin >= end || pixelCount == 0) return;
+    const float* wx = world.x.data() + begin;
+    const float* wy = world.y.data() + begin;
+    const size_t count = end - begin;
+
+    if (count < PARALLEL_MIN_POINTS) {
+        densityRange(wx, wy, 0, count, originX, originY, scale, width, height, grid.data());
+        return;
+    }
+
+    //      (  ),   
+    std::vector<std::vector<uint32_t>> partial(resolveThreadCount());
+    size_t chunks = parallelChunks(count, true, [&](size_t chunk, size_t chunkBegin, size_t chunkEnd) {
+        uint32_t* target = grid.data();
+        if (chunk > 0) {
+            partial[chunk].assign(pixelCount, 0);
+            target = partial[chunk].data();
+        }
+        densityRange(wx, wy, chunkBegin, chunkEnd, originX, originY, scale, width, height, target);
+    });
+    for (size_t c = 1; c < chunks && c < partial.size(); ++c) {
+        if (partial[c].empty()) continue;
+        const uint32_t* source = partial[c].data();
+        for (size_t i = 0; i < pixelCount; ++i) grid[i] += source[i];
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef SCREENPROJECTION_H
+#define SCREENPROJECTION_H
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+//      SoA: x  y    .
+// float -   ,      .
+struct WorldPointsSoA {
+    std::vector<float> x, y;
+
+    size_t size() const { return x.size(); }
+    void clear() { x.clear(); y.clear(); }
+};
+
+//  .    min > max.
+struct PointBounds {
+    float minX, maxX, minY, maxY;
+
+    bool isEmpty() const { return minX > maxX; }
+};
+
+//      :   ->    .
+//     4   SSE2 ( ),
+//     .
+class ScreenProjection {
+public:
+    // screen.x = originX + x * scale, screen.y = originY - y * scale
+    // (   ,    TrajectoryVisualizer::toScreenCoords)
+    static void project(const WorldPointsSoA& world, float originX, float originY, float scale,
+        const sf::Color& color, sf::Vertex* out);
+
+    static PointBounds computeBounds(const float* x, const float* y, size_t count);
+    static PointBounds computeBounds(const WorldPointsSoA& points);
+    //     (AoS):  SIMD,    
+    static PointBounds computeBounds(const sf::Vertex* vertices, size_t count);
+
+    //   [begin, end)    width x height: grid[py * width + px] -
+    //  ,    (px, py)    ,    project.
+    //     .
+    static void accumulateDensity(const WorldPointsSoA& world, size_t begin, size_t end,
+        float originX, float originY, float scale, unsigned int width, unsigned int height,
+        std::vector<uint32_t>& grid);
+
+private:
+    //         
+    static constexpr size_t PARALLEL_MIN_POINTS = 1 << 18;
+};
+
+#endif // SCREENPROJECTION_H
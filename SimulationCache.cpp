@@ -0,0 +1,232 @@
+#include "SimulationCache.h"
+#include "AtmosphereModel.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <iterator>
+
+#if defined(_WIN32)
+#include <direct.h>   // _mkdir
+#else
+#include <sys/stat.h> // mkdir
+#endif
+
+namespace {
+const char CACHE_FILE_MAGIC[4] = { 'T', 'R', 'J', 'C' };
+const uint32_t CACHE_FILE_FORMAT = 1;
+const size_t KEY_STEPS_INDEX = 7; //  STEPS   makeKey
+
+bool makeDirectory(const std::string& path) {
+#if defined(_WIN32)
+    return _mkdir(path.c_str()) == 0 || errno == EEXIST;
+#else
+    return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+#endif
+}
+}
+
+SimulationCache::SimulationCache(const std::string& directory, size_t maxMemoryBytes, size_t maxDiskEntryBytes)
+    : m_directory(directory),
+    m_maxMemoryBytes(maxMemoryBytes),
+    m_maxDiskEntryBytes(maxDiskEntryBytes),
+    m_memoryBytes(0),
+    m_diskEnabled(!directory.empty()),
+    m_directoryReady(false) {
+}
+
+//    -   .     SimulationParameters
+//    ,         .
+SimulationCache::Key SimulationCache::makeKey(const SimulationParameters& params) {
+    Key key;
+    key.reserve(17);
+    key.push_back(static_cast<double>(Calculations::INTEGRATOR_VERSION));
+    key.push_back(params.G);
+    key.push_back(params.M);
+    key.push_back(params.CENTRAL_BODY_RADIUS);
+    key.push_back(params.DRAG_COEFFICIENT);
+    key.push_back(params.THRUST_COEFFICIENT);
+    key.push_back(params.DT);
+    key.push_back(static_cast<double>(params.STEPS));
+    key.push_back(params.initialState.x);
+    key.push_back(params.initialState.y);
+    key.push_back(params.initialState.vx);
+    key.push_back(params.initialState.vy);
+    key.push_back(static_cast<double>(static_cast<int>(params.PRECISION)));
+    key.push_back(params.ANALYTIC_KEPLER ? 1.0 : 0.0);
+    key.push_back(params.SUNDMAN_STEP);
+    const bool atmosphere = params.ATMOSPHERE && params.ATMOSPHERE_DRAG != 0.0;
+    key.push_back(atmosphere ? params.ATMOSPHERE_DRAG : 0.0);
+    key.push_back(atmosphere ? params.ATMOSPHERE->fingerprint() : 0.0);
+    return key;
+}
+
+// FNV-1a   
+uint64_t SimulationCache::hashKey(const Key& key) {
+    uint64_t hash = 14695981039346656037ull;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(key.data());
+    for (size_t i = 0; i < key.size() * sizeof(double); ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint64_t SimulationCache::hashParameters(const SimulationParameters& params) {
+    return hashKey(makeKey(params));
+}
+
+std::string SimulationCache::filePathFor(uint64_t hash) const {
+    std::ostringstream oss;
+    oss << m_directory << "/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".traj";
+    return oss.str();
+}
+
+bool SimulationCache::lookup(const SimulationParameters& params, std::vector<State>& trajectoryStates) {
+    const Key key = makeKey(params);
+    const uint64_t hash = hashKey(key);
+
+    auto range = m_index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second->key != key) continue; //   
+        m_lru.splice(m_lru.begin(), m_lru, it->second); //    LRU
+        const std::vector<State>& cached = *it->second->states;
+        trajectoryStates.assign(cached.begin(), cached.end());
+        std::cout << "SimulationCache:     (" << cached.size() << " )\n";
+        return true;
+    }
+
+    if (m_diskEnabled && loadFromDisk(hash, key, trajectoryStates)) {
+        std::cout << "SimulationCache:     (" << trajectoryStates.size() << " )\n";
+        insertIntoMemory(hash, key, std::make_shared<const std::vector<State>>(trajectoryStates));
+        return true;
+    }
+    return false;
+}
+
+void SimulationCache::store(const SimulationParameters& params, const std::vector<State>& trajectoryStates) {
+    if (trajectoryStates.empty()) return;
+    const Key key = makeKey(params);
+    const uint64_t hash = hashKey(key);
+
+    auto range = m_index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second->key == key) return; //  
+    }
+
+    insertIntoMemory(hash, key, std::make_shared<const std::vector<State>>(trajectoryStates));
+    if (m_diskEnabled) {
+        saveToDisk(hash, key, trajectoryStates);
+    }
+}
+
+void SimulationCache::clearMemory() {
+    m_lru.clear();
+    m_index.clear();
+    m_memoryBytes = 0;
+}
+
+void SimulationCache::insertIntoMemory(uint64_t hash, const Key& key, std::shared_ptr<const std::vector<State>> states) {
+    size_t bytes = states->size() * sizeof(State);
+    if (bytes > m_maxMemoryBytes) return; //    -    
+
+    m_lru.push_front({ hash, key, std::move(states) });
+    m_index.emplace(hash, m_lru.begin());
+    m_memoryBytes += bytes;
+    evictIfNeeded();
+}
+
+void SimulationCache::evictIfNeeded() {
+    while (m_memoryBytes > m_maxMemoryBytes && !m_lru.empty()) {
+        auto last = std::prev(m_lru.end());
+        auto range = m_index.equal_range(last->hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == last) { m_index.erase(it); break; }
+        }
+        m_memoryBytes -= last->states->size() * sizeof(State);
+        m_lru.erase(last);
+    }
+}
+
+//  : magic[4],  (uint32),   (uint32),  (double[]),
+//   (uint64),  (State[], 4 double )
+bool SimulationCache::loadFromDisk(uint64_t hash, const Key& key, std::vector<State>& trajectoryStates) const {
+    std::ifstream file(filePathFor(hash), std::ios::binary);
+    if (!file.is_open()) return false;
+
+    char magic[4];
+    uint32_t format = 0, keySize = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&format), sizeof(format));
+    file.read(reinterpret_cast<char*>(&keySize), sizeof(keySize));
+    if (!file || std::memcmp(magic, CACHE_FILE_MAGIC, sizeof(magic)) != 0 ||
+        format != CACHE_FILE_FORMAT || keySize != key.size()) {
+        return false;
+    }
+
+    Key storedKey(keySize);
+    file.read(reinterpret_cast<char*>(storedKey.data()), keySize * sizeof(double));
+    if (!file || storedKey != key) return false; //      
+
+    uint64_t count = 0;
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!file || count == 0) return false;
+
+    //      :     STEPS + 1 ,   
+    //    .         .
+    const std::streampos dataStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::streamoff dataBytes = file.tellg() - dataStart;
+    file.seekg(dataStart);
+    const double maxStates = key[KEY_STEPS_INDEX] + 1.0;
+    if (!file || dataBytes < 0 || count > static_cast<uint64_t>(dataBytes) / sizeof(State) ||
+        static_cast<double>(count) > maxStates) {
+        std::cerr << "SimulationCache:    " << filePathFor(hash) << "\n";
+        return false;
+    }
+
+    trajectoryStates.resize(static_cast<size_t>(count));
+    file.read(reinterpret_cast<char*>(trajectoryStates.data()), static_cast<std::streamsize>(count * sizeof(State)));
+    if (!file) {
+        std::cerr << "SimulationCache:    " << filePathFor(hash) << "\n";
+        trajectoryStates.clear();
+        return false;
+    }
+    return true;
+}
+
+void SimulationCache::saveToDisk(uint64_t hash, const Key& key, const std::vector<State>& trajectoryStates) {
+    if (trajectoryStates.size() * sizeof(State) > m_maxDiskEntryBytes) return;
+    if (!m_directoryReady) {
+        m_directoryReady = makeDirectory(m_directory);
+        if (!m_directoryReady) {
+            std::cerr << "SimulationCache:     " << m_directory << ",    \n";
+            m_diskEnabled = false;
+            return;
+        }
+    }
+
+    std::string path = filePathFor(hash);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "SimulationCache:    " << path << "  \n";
+        return;
+    }
+    uint32_t keySize = static_cast<uint32_t>(key.size());
+    uint64_t count = trajectoryStates.size();
+    file.write(CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC));
+    file.write(reinterpret_cast<const char*>(&CACHE_FILE_FORMAT), sizeof(CACHE_FILE_FORMAT));
+    file.write(reinterpret_cast<const char*>(&keySize), sizeof(keySize));
+    file.write(reinterpret_cast<const char*>(key.data()), key.size() * sizeof(double));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    file.write(reinterpret_cast<const char*>(trajectoryStates.data()), static_cast<std::streamsize>(count * sizeof(State)));
+    file.close();
+    if (!file) {
+        std::cerr << "SimulationCache:   " << path << "\n";
+        std::remove(path.c_str()); //        
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef SIMULATIONCACHE_H
+#define SIMULATIONCACHE_H
+
+#include <vector>
+#include <string>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+#include "Calculations.h"
+
+//   .  -   SimulationParameters 
+// Calculations::INTEGRATOR_VERSION,       
+//    .
+//  -  : LRU      ;
+//  -  :    , <>/<>.traj,  State   .
+class SimulationCache {
+public:
+    SimulationCache(const std::string& directory = "simulation_cache",
+        size_t maxMemoryBytes = 512u * 1024u * 1024u,
+        size_t maxDiskEntryBytes = 256u * 1024u * 1024u);
+
+    // true -   (    )    trajectoryStates
+    bool lookup(const SimulationParameters& params, std::vector<State>& trajectoryStates);
+    void store(const SimulationParameters& params, const std::vector<State>& trajectoryStates);
+
+    void setDiskEnabled(bool enabled) { m_diskEnabled = enabled; }
+    void clearMemory();
+
+    static uint64_t hashParameters(const SimulationParameters& params);
+
+    typedef std::vector<double> Key; //     +  
+    static Key makeKey(const SimulationParameters& params);
+
+private:
+
+    struct Entry {
+        uint64_t hash;
+        Key key;
+        std::shared_ptr<const std::vector<State>> states;
+    };
+
+    static uint64_t hashKey(const Key& key);
+    std::string filePathFor(uint64_t hash) const;
+
+    bool loadFromDisk(uint64_t hash, const Key& key, std::vector<State>& trajectoryStates) const;
+    void saveToDisk(uint64_t hash, const Key& key, const std::vector<State>& trajectoryStates);
+    void insertIntoMemory(uint64_t hash, const Key& key, std::shared_ptr<const std::vector<State>> states);
+    void evictIfNeeded();
+
+    std::string m_directory;
+    size_t m_maxMemoryBytes;
+    size_t m_maxDiskEntryBytes;
+    size_t m_memoryBytes;
+    bool m_diskEnabled;
+    bool m_directoryReady;
+
+    std::list<Entry> m_lru; //   -    
+    std::unordered_multimap<uint64_t, std::list<Entry>::iterator> m_index;
+};
+
+#endif // SIMULATIONCACHE_H
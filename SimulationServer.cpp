@@ -0,0 +1,270 @@
+#include "SimulationServer.h"
+#include "OrbitAnalytics.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <locale>
+#include <new>
+#include <sstream>
+#include <thread>
+
+namespace {
+const char FRAME_MAGIC[4] = { 'T', 'R', 'J', 'R' };
+
+unsigned int resolveThreadCount(unsigned int requested) {
+    if (requested > 0) return requested;
+    unsigned int hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+//       :      
+//  setlocale  (strtod  "Rus"   )
+template <typename Number>
+bool parseNumber(const std::string& text, Number& value) {
+    std::istringstream in(text);
+    in.imbue(std::locale::classic());
+    return static_cast<bool>(in >> value) && in.peek() == std::char_traits<char>::eof();
+}
+}
+
+constexpr size_t SimulationServer::MAX_BATCH_JOBS;
+constexpr int SimulationServer::RESULT_CHUNK_STEPS;
+
+SimulationServer::SimulationServer(unsigned int threadCount)
+    : m_threadCount(resolveThreadCount(threadCount)),
+    m_out(nullptr),
+    m_closing(false) {
+}
+
+bool SimulationServer::parseJob(const std::string& line, Job& job, std::string& error) {
+    job.id = 0;
+    job.params = SimulationParameters();
+    job.output = Output::Final;
+
+    // id  ,          id 
+    std::istringstream fields(line);
+    std::string field;
+    while (fields >> field) {
+        if (field.compare(0, 3, "id=") != 0) continue;
+        if (!parseNumber(field.substr(3), job.id)) {
+            job.id = 0;
+            error = " : " + field;
+            return false;
+        }
+    }
+
+    fields.clear();
+    fields.seekg(0);
+    while (fields >> field) {
+        const size_t separator = field.find('=');
+        if (separator == std::string::npos) {
+            error = " =: " + field;
+            return false;
+        }
+        const std::string key = field.substr(0, separator);
+        const std::string text = field.substr(separator + 1);
+        SimulationParameters& params = job.params;
+        double value = 0.0;
+        if (key == "precision") {
+            if (!Calculations::parsePrecision(text, params.PRECISION)) {
+                error = "  " + text;
+                return false;
+            }
+            continue;
+        }
+        if (key == "output") {
+            if (text == "states") job.output = Output::States;
+            else if (text == "final") job.output = Output::Final;
+            else if (text == "summary") job.output = Output::Summary;
+            else {
+                error = "   " + text;
+                return false;
+            }
+            continue;
+        }
+        if (key == "id") continue; //  
+        if (!parseNumber(text, value)) {
+            error = " : " + field;
+            return false;
+        }
+        if (key == "steps") {
+            //   int      -   
+            if (!(value >= 0.0 && value <= static_cast<double>(INT_MAX)) || value != std::floor(value)) {
+                error = "steps     0  " + std::to_string(INT_MAX) + ": " + field;
+                return false;
+            }
+            params.STEPS = static_cast<int>(value);
+        }
+        else if (key == "dt") params.DT = value;
+        else if (key == "G") params.G = value;
+        else if (key == "M") params.M = value;
+        else if (key == "R") params.CENTRAL_BODY_RADIUS = value;
+        else if (key == "k") params.DRAG_COEFFICIENT = value;
+        else if (key == "F") params.THRUST_COEFFICIENT = value;
+        else if (key == "x") params.initialState.x = value;
+        else if (key == "y") params.initialState.y = value;
+        else if (key == "vx") params.initialState.vx = value;
+        else if (key == "vy") params.initialState.vy = value;
+        else if (key == "sundman") params.SUNDMAN_STEP = value;
+        else if (key == "analytic") params.ANALYTIC_KEPLER = value != 0.0;
+        else {
+            error = "  " + key;
+            return false;
+        }
+    }
+    if (!(job.params.DT > 0.0) || !std::isfinite(job.params.DT)) {
+        error = "dt      0";
+        return false;
+    }
+    return true;
+}
+
+bool SimulationServer::takeBatch(std::vector<Job>& batch) {
+    batch.clear();
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+    m_queueReady.wait(lock, [this]() { return m_closing || !m_queue.empty(); });
+    if (m_queue.empty()) return false;
+
+    //          (  )
+    batch.push_back(m_queue.front());
+    m_queue.pop_front();
+    for (auto it = m_queue.begin(); it != m_queue.end() && batch.size() < MAX_BATCH_JOBS;) {
+        if (it->output == batch.front().output && it->params.PRECISION == batch.front().params.PRECISION) {
+            batch.push_back(*it);
+            it = m_queue.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    return true;
+}
+
+void SimulationServer::appendFrame(std::string& frames, Output output, uint64_t id, int32_t status,
+    uint32_t count, const void* payload, size_t payloadBytes) {
+    const uint32_t outputCode = static_cast<uint32_t>(output);
+    frames.append(FRAME_MAGIC, sizeof(FRAME_MAGIC));
+    frames.append(reinterpret_cast<const char*>(&outputCode), sizeof(outputCode));
+    frames.append(reinterpret_cast<const char*>(&id), sizeof(id));
+    frames.append(reinterpret_cast<const char*>(&status), sizeof(status));
+    frames.append(reinterpret_cast<const char*>(&count), sizeof(count));
+    frames.append(static_cast<const char*>(payload), payloadBytes);
+}
+
+void SimulationServer::writeFrames(const std::string& frames) {
+    std::lock_guard<std::mutex> lock(m_outputMutex);
+    m_out->write(frames.data(), static_cast<std::streamsize>(frames.size()));
+    m_out->flush();
+}
+
+void SimulationServer::workerLoop() {
+    //       :      
+    Calculations calculator;
+    OrbitAnalytics analytics;
+    std::vector<State> states;
+    std::vector<Job> batch;
+    std::string frames;
+
+    while (takeBatch(batch)) {
+        frames.clear();
+        for (const Job& job : batch) {
+            //    (,  ) -    -1,    
+            const size_t frameStart = frames.size();
+            std::string error;
+            try {
+                runJob(job, calculator, analytics, states, frames);
+            }
+            catch (const std::bad_alloc&) {
+                error = "  ";
+            }
+            catch (const std::exception& e) {
+                error = e.what();
+            }
+            if (!error.empty()) {
+                std::cerr << "SimulationServer:  " << job.id << ": " << error << "\n";
+                frames.resize(frameStart); //    
+                appendFrame(frames, job.output, job.id, -1, static_cast<uint32_t>(error.size()), error.data(), error.size());
+            }
+        }
+        writeFrames(frames);
+    }
+}
+
+void SimulationServer::runJob(const Job& job, Calculations& calculator, OrbitAnalytics& analytics,
+    std::vector<State>& states, std::string& frames) {
+    if (job.output == Output::States) {
+        calculator.runSimulation(job.params, states);
+        const int32_t status = static_cast<int>(states.size()) - 1 < job.params.STEPS ? 1 : 0;
+        appendFrame(frames, job.output, job.id, status, static_cast<uint32_t>(states.size()),
+            states.data(), states.size() * sizeof(State));
+        return;
+    }
+
+    //  final  summary    : ,     
+    SimulationParameters initialOnly = job.params;
+    initialOnly.STEPS = 0;
+    OrbitAnalytics* summaryAnalytics = job.output == Output::Summary ? &analytics : nullptr;
+    calculator.runSimulation(initialOnly, states, summaryAnalytics);
+    const State& start = states.front();
+    bool collided = start.x * start.x + start.y * start.y < job.params.CENTRAL_BODY_RADIUS * job.params.CENTRAL_BODY_RADIUS;
+    int completed = 0;
+    while (!collided && completed < job.params.STEPS) {
+        const int chunk = std::min(RESULT_CHUNK_STEPS, job.params.STEPS - completed);
+        collided = calculator.continueSimulation(job.params, 0, chunk, states, summaryAnalytics);
+        completed += chunk;
+        const State last = states.back();
+        states.assign(1, last);
+    }
+    const int32_t status = collided ? 1 : 0;
+
+    if (job.output == Output::Final) {
+        appendFrame(frames, job.output, job.id, status, 1, &states.back(), sizeof(State));
+        return;
+    }
+    const OrbitAnalytics::Summary s = analytics.getSummary();
+    const double values[] = { s.duration, static_cast<double>(s.orbits), s.period, s.eccentricityFinal,
+        s.periapsis, s.apoapsis, s.minRadius, s.maxRadius, s.energyInitial, s.energyFinal, s.semiMajorAxisRate };
+    appendFrame(frames, job.output, job.id, status, sizeof(values) / sizeof(values[0]), values, sizeof(values));
+}
+
+size_t SimulationServer::serve(std::istream& in, std::ostream& out) {
+    m_out = &out;
+    m_closing = false;
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < m_threadCount; ++t) workers.emplace_back(&SimulationServer::workerLoop, this);
+
+    size_t jobCount = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+        if (line == "quit") break;
+
+        Job job;
+        std::string error;
+        ++jobCount;
+        if (!parseJob(line, job, error)) {
+            std::cerr << "SimulationServer: " << error << "\n";
+            std::string frame;
+            appendFrame(frame, job.output, job.id, -1, static_cast<uint32_t>(error.size()), error.data(), error.size());
+            writeFrames(frame);
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            m_queue.push_back(job);
+        }
+        m_queueReady.notify_one();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        m_closing = true;
+    }
+    m_queueReady.notify_all();
+    for (auto& worker : workers) worker.join();
+    return jobCount;
+}
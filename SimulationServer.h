@@ -0,0 +1,82 @@
+#ifndef SIMULATIONSERVER_H
+#define SIMULATIONSERVER_H
+
+#include <cstdint>
+#include <condition_variable>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Calculations.h"
+#include "OrbitAnalytics.h"
+
+//   :      ( stdin -),
+//     (stdout). ,     
+//  ,      ,    .
+//
+//  -  =  ,     SimulationParameters:
+//   id=<uint64> steps= dt= G= M= R= k= F= x= y= vx= vy= sundman= analytic=0|1
+//   precision=float|double|long-double|kahan output=states|final|summary
+//  "quit" (  ) -     .
+//
+//   (  ):
+//   char magic[4] = "TRJR"; uint32 output (0 - states, 1 - final, 2 - summary);
+//   uint64 id; int32 status (0 -  , 1 - , -1 -    );
+//   uint32 count;  count :
+//     states  - State (x, y, vx, vy: 4 double)   ,
+//     final   -  State  ,
+//     summary - double: duration, orbits, period, eccentricityFinal, periapsis, apoapsis,
+//               minRadius, maxRadius, energyInitial, energyFinal, semiMajorAxisRate,
+//       -   .
+//     ,    -   id.
+//
+//          (     
+//  ),           
+//        .
+class SimulationServer {
+public:
+    // threadCount = 0 -    
+    explicit SimulationServer(unsigned int threadCount = 0);
+
+    //    in  "quit"   ,    out.
+    //    .
+    size_t serve(std::istream& in, std::ostream& out);
+
+private:
+    static constexpr size_t MAX_BATCH_JOBS = 32;
+    static constexpr int RESULT_CHUNK_STEPS = 2000; //    final  summary
+
+    enum class Output : uint32_t { States = 0, Final = 1, Summary = 2 };
+
+    struct Job {
+        uint64_t id;
+        SimulationParameters params;
+        Output output;
+    };
+
+    static bool parseJob(const std::string& line, Job& job, std::string& error);
+    //    ; false -    
+    bool takeBatch(std::vector<Job>& batch);
+    void workerLoop();
+    //        frames;   workerLoop
+    static void runJob(const Job& job, Calculations& calculator, OrbitAnalytics& analytics,
+        std::vector<State>& states, std::string& frames);
+    static void appendFrame(std::string& frames, Output output, uint64_t id, int32_t status,
+        uint32_t count, const void* payload, size_t payloadBytes);
+    void writeFrames(const std::string& frames);
+
+    unsigned int m_threadCount;
+    std::ostream* m_out;
+
+    std::mutex m_queueMutex;
+    std::condition_variable m_queueReady;
+    std::deque<Job> m_queue;
+    bool m_closing;
+
+    std::mutex m_outputMutex;
+};
+
+#endif // SIMULATIONSERVER_H
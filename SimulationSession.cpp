@@ -0,0 +1,245 @@
+#include "SimulationSession.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+const char CHECKPOINT_MAGIC[4] = { 'T', 'R', 'J', 'S' };
+const uint32_t CHECKPOINT_FORMAT = 1;
+}
+
+SimulationSession::SimulationSession()
+    : m_valid(false),
+    m_completedSteps(0),
+    m_terminated(false),
+    m_checkpointIntervalSteps(0) {
+}
+
+void SimulationSession::setCheckpointPath(const std::string& basePath, int checkpointIntervalSteps) {
+    m_checkpointBasePath = basePath;
+    m_checkpointIntervalSteps = checkpointIntervalSteps;
+}
+
+void SimulationSession::reset() {
+    m_valid = false;
+    m_key.clear();
+    m_completedSteps = 0;
+    m_terminated = false;
+    m_analyticsKey.clear();
+}
+
+void SimulationSession::syncAnalytics(const SimulationParameters& params, const std::vector<State>& trajectoryStates) {
+    const SimulationCache::Key key = continuationKey(params);
+    if (key == m_analyticsKey && m_analytics.getSampleCount() == trajectoryStates.size()) return;
+    m_analytics.reset(params);
+    for (const State& state : trajectoryStates) {
+        m_analytics.addState(state);
+    }
+    m_analyticsKey = key;
+}
+
+bool SimulationSession::isExactlyResumable(Precision precision) {
+    return precision == Precision::Float || precision == Precision::Double;
+}
+
+SimulationCache::Key SimulationSession::continuationKey(const SimulationParameters& params) {
+    SimulationParameters withoutSteps = params;
+    withoutSteps.STEPS = 0;
+    return SimulationCache::makeKey(withoutSteps);
+}
+
+void SimulationSession::adopt(const SimulationParameters& params, const std::vector<State>& trajectoryStates) {
+    if (trajectoryStates.empty()) { reset(); return; }
+    m_valid = true;
+    m_key = continuationKey(params);
+    m_completedSteps = static_cast<int>(trajectoryStates.size()) - 1;
+    m_terminated = m_completedSteps < params.STEPS; // Calculations     
+    syncAnalytics(params, trajectoryStates);
+}
+
+int SimulationSession::run(const SimulationParameters& params, std::vector<State>& trajectoryStates) {
+    const SimulationCache::Key key = continuationKey(params);
+    const int targetSteps = std::max(0, params.STEPS);
+
+    bool canContinue = m_valid && key == m_key &&
+        trajectoryStates.size() == static_cast<size_t>(m_completedSteps) + 1;
+    if (!canContinue) {
+        canContinue = restoreCheckpoint(key, trajectoryStates);
+    }
+
+    if (canContinue && targetSteps <= m_completedSteps) {
+        // T :     
+        if (targetSteps < m_completedSteps) {
+            std::cout << "SimulationSession:    " << targetSteps << "   \n";
+            m_terminated = false;
+        }
+        trajectoryStates.resize(static_cast<size_t>(targetSteps) + 1);
+        m_completedSteps = targetSteps;
+        syncAnalytics(params, trajectoryStates);
+        return 0;
+    }
+    if (canContinue && !isExactlyResumable(params.PRECISION)) {
+        // long double       State -   
+        // ,      (  ,    )
+        canContinue = false;
+    }
+    if (canContinue && m_terminated) {
+        std::cout << "SimulationSession:       " << m_completedSteps << "\n";
+        syncAnalytics(params, trajectoryStates);
+        return 0;
+    }
+
+    Calculations calculator;
+    int firstStep = 0;
+    if (canContinue) {
+        firstStep = m_completedSteps;
+        std::cout << "SimulationSession:     " << firstStep << "  " << targetSteps << "\n";
+        syncAnalytics(params, trajectoryStates); //     -   
+    }
+    else {
+        //  :      -   runSimulation
+        SimulationParameters initialOnly = params;
+        initialOnly.STEPS = 0;
+        calculator.runSimulation(initialOnly, trajectoryStates, &m_analytics);
+        m_analyticsKey = key;
+        m_valid = true;
+        m_key = key;
+        m_completedSteps = 0;
+        m_terminated = false;
+
+        const State& start = trajectoryStates.front();
+        if (start.x * start.x + start.y * start.y < params.CENTRAL_BODY_RADIUS * params.CENTRAL_BODY_RADIUS) {
+            m_terminated = true;
+            return 0;
+        }
+    }
+
+    //      m_checkpointIntervalSteps,     
+    // (    State,    ,    )
+    const bool checkpointing = !m_checkpointBasePath.empty() && m_checkpointIntervalSteps > 0 &&
+        targetSteps - firstStep >= m_checkpointIntervalSteps && isExactlyResumable(params.PRECISION);
+    const int chunk = checkpointing ? m_checkpointIntervalSteps : targetSteps - firstStep;
+    if (checkpointing) {
+        //       :   ( adopt()  
+        //      )  .states     
+        writeCheckpoint(trajectoryStates, 0);
+    }
+
+    while (m_completedSteps < targetSteps && !m_terminated) {
+        int chunkStart = m_completedSteps;
+        int chunkEnd = std::min(targetSteps, chunkStart + chunk);
+        m_terminated = calculator.continueSimulation(params, chunkStart, chunkEnd, trajectoryStates, &m_analytics);
+        m_completedSteps = static_cast<int>(trajectoryStates.size()) - 1;
+        if (checkpointing) {
+            writeCheckpoint(trajectoryStates, static_cast<size_t>(chunkStart) + 1);
+        }
+    }
+    return m_completedSteps - firstStep;
+}
+
+//  <base>.ckpt: magic[4],  (uint32),   (uint32),  (double[]),
+//    (int32),   (uint8).
+// <base>.states: State[] ,   i    i * sizeof(State).
+void SimulationSession::writeCheckpoint(const std::vector<State>& trajectoryStates, size_t firstNewState) {
+    const std::string statesPath = m_checkpointBasePath + ".states";
+    const std::string checkpointPath = m_checkpointBasePath + ".ckpt";
+
+    //   ,     .ckpt:    
+    //  ,     
+    std::fstream states(statesPath, std::ios::binary | std::ios::in | std::ios::out);
+    if (!states.is_open() || firstNewState == 0) {
+        //  .ckpt     .states:    
+        //       
+        std::remove(checkpointPath.c_str());
+        states.close();
+        states.open(statesPath, std::ios::binary | std::ios::out | std::ios::trunc);
+    }
+    if (!states.is_open()) {
+        std::cerr << "SimulationSession:    " << statesPath << "  \n";
+        return;
+    }
+    states.seekp(static_cast<std::streamoff>(firstNewState * sizeof(State)));
+    states.write(reinterpret_cast<const char*>(trajectoryStates.data() + firstNewState),
+        static_cast<std::streamsize>((trajectoryStates.size() - firstNewState) * sizeof(State)));
+    states.flush();
+    if (!states) {
+        std::cerr << "SimulationSession:   " << statesPath << "\n";
+        return;
+    }
+    states.close();
+
+    std::ofstream checkpoint(checkpointPath, std::ios::binary | std::ios::trunc);
+    if (!checkpoint.is_open()) {
+        std::cerr << "SimulationSession:    " << checkpointPath << "  \n";
+        return;
+    }
+    uint32_t keySize = static_cast<uint32_t>(m_key.size());
+    int32_t completedSteps = m_completedSteps;
+    uint8_t terminated = m_terminated ? 1 : 0;
+    checkpoint.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    checkpoint.write(reinterpret_cast<const char*>(&CHECKPOINT_FORMAT), sizeof(CHECKPOINT_FORMAT));
+    checkpoint.write(reinterpret_cast<const char*>(&keySize), sizeof(keySize));
+    checkpoint.write(reinterpret_cast<const char*>(m_key.data()), m_key.size() * sizeof(double));
+    checkpoint.write(reinterpret_cast<const char*>(&completedSteps), sizeof(completedSteps));
+    checkpoint.write(reinterpret_cast<const char*>(&terminated), sizeof(terminated));
+    checkpoint.close();
+    if (!checkpoint) {
+        std::cerr << "SimulationSession:   " << checkpointPath << "\n";
+        std::remove(checkpointPath.c_str()); //        
+    }
+}
+
+bool SimulationSession::restoreCheckpoint(const SimulationCache::Key& key, std::vector<State>& trajectoryStates) {
+    if (m_checkpointBasePath.empty()) return false;
+    std::ifstream checkpoint(m_checkpointBasePath + ".ckpt", std::ios::binary);
+    if (!checkpoint.is_open()) return false;
+
+    char magic[4];
+    uint32_t format = 0, keySize = 0;
+    checkpoint.read(magic, sizeof(magic));
+    checkpoint.read(reinterpret_cast<char*>(&format), sizeof(format));
+    checkpoint.read(reinterpret_cast<char*>(&keySize), sizeof(keySize));
+    if (!checkpoint || std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0 ||
+        format != CHECKPOINT_FORMAT || keySize != key.size()) {
+        return false;
+    }
+    SimulationCache::Key storedKey(keySize);
+    checkpoint.read(reinterpret_cast<char*>(storedKey.data()), keySize * sizeof(double));
+    int32_t completedSteps = 0;
+    uint8_t terminated = 0;
+    checkpoint.read(reinterpret_cast<char*>(&completedSteps), sizeof(completedSteps));
+    checkpoint.read(reinterpret_cast<char*>(&terminated), sizeof(terminated));
+    if (!checkpoint || storedKey != key || completedSteps < 0) return false;
+
+    std::ifstream states(m_checkpointBasePath + ".states", std::ios::binary);
+    if (!states.is_open()) return false;
+    //   .ckpt    ,   SimulationCache::loadFromDisk:  
+    //     .states,         
+    const uint64_t stateCount = static_cast<uint64_t>(completedSteps) + 1;
+    states.seekg(0, std::ios::end);
+    const std::streamoff fileBytes = states.tellg();
+    states.seekg(0);
+    if (!states || fileBytes < 0 || stateCount > static_cast<uint64_t>(fileBytes) / sizeof(State)) {
+        std::cerr << "SimulationSession:     ,   \n";
+        return false;
+    }
+    trajectoryStates.resize(static_cast<size_t>(stateCount));
+    states.read(reinterpret_cast<char*>(trajectoryStates.data()),
+        static_cast<std::streamsize>(trajectoryStates.size() * sizeof(State)));
+    if (!states) {
+        std::cerr << "SimulationSession:     ,   \n";
+        trajectoryStates.clear();
+        return false;
+    }
+
+    m_valid = true;
+    m_key = key;
+    m_completedSteps = completedSteps;
+    m_terminated = terminated != 0;
+    std::cout << "SimulationSession:      " << completedSteps << "\n";
+    return true;
+}
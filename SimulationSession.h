@@ -0,0 +1,65 @@
+#ifndef SIMULATIONSESSION_H
+#define SIMULATIONSESSION_H
+
+#include <vector>
+#include <string>
+
+#include "Calculations.h"
+#include "SimulationCache.h" // SimulationCache::makeKey -  
+#include "OrbitAnalytics.h"
+
+//  .       :
+//      ( T  ),   
+//    ,    T   .
+//
+//        
+// (<base>.ckpt -    , <base>.states -  ),
+//             .
+//
+//     OrbitAnalytics:   -    ,
+//    (,  , ) -    .
+class SimulationSession {
+public:
+    SimulationSession();
+
+    // checkpointIntervalSteps <= 0    -    
+    void setCheckpointPath(const std::string& basePath, int checkpointIntervalSteps);
+
+    //     params. trajectoryStates -   ,  
+    //   :    ,      .
+    //   ,    .
+    int run(const SimulationParameters& params, std::vector<State>& trajectoryStates);
+
+    //    (,   SimulationCache),  
+    //    
+    void adopt(const SimulationParameters& params, const std::vector<State>& trajectoryStates);
+
+    void reset();
+
+    //    run / adopt
+    const OrbitAnalytics& getAnalytics() const { return m_analytics; }
+
+private:
+    //     :  ,    
+    static SimulationCache::Key continuationKey(const SimulationParameters& params);
+    //         State (double)
+    static bool isExactlyResumable(Precision precision);
+
+    bool restoreCheckpoint(const SimulationCache::Key& key, std::vector<State>& trajectoryStates);
+    void writeCheckpoint(const std::vector<State>& trajectoryStates, size_t firstNewState);
+    //  m_analytics  trajectoryStates,      
+    void syncAnalytics(const SimulationParameters& params, const std::vector<State>& trajectoryStates);
+
+    bool m_valid;
+    SimulationCache::Key m_key;
+    int m_completedSteps;  //     (trajectoryStates.size() - 1)
+    bool m_terminated;     //    -  
+
+    OrbitAnalytics m_analytics;
+    SimulationCache::Key m_analyticsKey; //  (  ),    m_analytics
+
+    std::string m_checkpointBasePath;
+    int m_checkpointIntervalSteps;
+};
+
+#endif // SIMULATIONSESSION_H
@@ -0,0 +1,231 @@
+#include "TargetingSolver.h"
+#include "OrbitAnalytics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <thread>
+
+namespace {
+
+unsigned int resolveThreadCount(unsigned int requested) {
+    if (requested > 0) return requested;
+    unsigned int hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+//   [0, count)   :    
+//   ,      
+template <typename Fn>
+void parallelForEach(size_t count, unsigned int threadCount, Fn fn) {
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for (size_t i = next++; i < count; i = next++) fn(i);
+    };
+    size_t workerCount = std::min<size_t>(threadCount, count);
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < workerCount; ++t) workers.emplace_back(worker);
+    worker();
+    for (auto& w : workers) w.join();
+}
+
+const char* variableName(TargetingVariable variable) {
+    return variable == TargetingVariable::Thrust ? "F" : "V0";
+}
+
+const char* goalName(TargetingGoal goal) {
+    switch (goal) {
+    case TargetingGoal::FinalRadius: return " ";
+    case TargetingGoal::MinimumRadius: return " ";
+    case TargetingGoal::Period:
+    default: return "";
+    }
+}
+
+//    ,    ; -1,   
+int findSignChange(const std::vector<double>& residuals) {
+    for (size_t i = 0; i + 1 < residuals.size(); ++i) {
+        if ((residuals[i] > 0.0) != (residuals[i + 1] > 0.0)) return static_cast<int>(i);
+    }
+    return -1;
+}
+
+}
+
+constexpr double TargetingSolver::WARM_START_FRACTION;
+constexpr int TargetingSolver::EVALUATION_CHUNK_STEPS;
+
+TargetingSolver::TargetingSolver() {
+}
+
+double TargetingSolver::evaluate(const SimulationParameters& params, TargetingVariable variable, double value,
+    TargetingGoal goal, double target, bool earlyStop, long long& steps) {
+    SimulationParameters candidate = params;
+    if (variable == TargetingVariable::Thrust) candidate.THRUST_COEFFICIENT = value;
+    else candidate.initialState.vy = value;
+
+    Calculations calculator;
+    OrbitAnalytics analytics;
+    std::vector<State> states;
+    SimulationParameters initialOnly = candidate;
+    initialOnly.STEPS = 0;
+    calculator.runSimulation(initialOnly, states, &analytics);
+    steps = 0;
+
+    const State& start = states.front();
+    bool collided = start.x * start.x + start.y * start.y < candidate.CENTRAL_BODY_RADIUS * candidate.CENTRAL_BODY_RADIUS;
+    int completed = 0;
+    while (!collided && completed < candidate.STEPS) {
+        //    0   :      
+        const int chunk = std::min(EVALUATION_CHUNK_STEPS, candidate.STEPS - completed);
+        collided = calculator.continueSimulation(candidate, 0, chunk, states, &analytics);
+        completed += chunk;
+        steps += static_cast<long long>(states.size()) - 1;
+        const State last = states.back();
+        states.assign(1, last);
+
+        if (goal == TargetingGoal::Period) {
+            if (analytics.getSummary().orbits >= 1) break; //    
+        }
+        else if (earlyStop && goal == TargetingGoal::MinimumRadius) {
+            const double minRadius = analytics.getSummary().minRadius;
+            if (minRadius < target) return minRadius;
+        }
+    }
+
+    const OrbitAnalytics::Summary summary = analytics.getSummary();
+    switch (goal) {
+    case TargetingGoal::Period:
+        if (summary.orbits >= 1) return summary.lastPeriod;
+        return collided ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+    case TargetingGoal::FinalRadius: {
+        const State& last = states.back();
+        return std::sqrt(last.x * last.x + last.y * last.y);
+    }
+    case TargetingGoal::MinimumRadius:
+    default:
+        return summary.minRadius;
+    }
+}
+
+TargetingReport TargetingSolver::solve(const SimulationParameters& params, const TargetingParameters& targeting) {
+    TargetingReport report;
+    const auto startTime = std::chrono::steady_clock::now();
+    const unsigned int threadCount = resolveThreadCount(targeting.THREADS);
+    const double searchMin = std::min(targeting.SEARCH_MIN, targeting.SEARCH_MAX);
+    const double searchMax = std::max(targeting.SEARCH_MIN, targeting.SEARCH_MAX);
+
+    //  ( - TARGET)    ,    
+    std::atomic<long long> totalSteps(0);
+    auto evaluateAll = [&](const std::vector<double>& points, std::vector<double>& residuals) {
+        residuals.assign(points.size(), 0.0);
+        parallelForEach(points.size(), threadCount, [&](size_t i) {
+            long long steps = 0;
+            residuals[i] = evaluate(params, targeting.VARIABLE, points[i], targeting.GOAL, targeting.TARGET, true, steps) -
+                targeting.TARGET;
+            totalSteps += steps;
+        });
+        report.evaluations += static_cast<int>(points.size());
+    };
+    //  [a, b]     :         
+    auto spread = [&](double a, double b, bool withEnds) {
+        const size_t interior = withEnds ? (threadCount > 2 ? threadCount - 2 : 0) : std::max(1u, threadCount);
+        std::vector<double> points;
+        if (withEnds) points.push_back(a);
+        for (size_t j = 1; j <= interior; ++j) {
+            points.push_back(a + (b - a) * static_cast<double>(j) / static_cast<double>(interior + 1));
+        }
+        if (withEnds) points.push_back(b);
+        return points;
+    };
+
+    double lower = 0.0, upper = 0.0, lowerResidual = 0.0, upperResidual = 0.0;
+    bool bracketed = false;
+    std::vector<double> points, residuals;
+
+    //  :        
+    for (const Solution& solution : m_solutions) {
+        if (solution.variable != targeting.VARIABLE || solution.goal != targeting.GOAL) continue;
+        if (solution.value < searchMin || solution.value > searchMax) break;
+        const double width = WARM_START_FRACTION * (searchMax - searchMin);
+        points = spread(std::max(searchMin, solution.value - width), std::min(searchMax, solution.value + width), true);
+        evaluateAll(points, residuals);
+        const int change = findSignChange(residuals);
+        if (change >= 0) {
+            lower = points[change];
+            upper = points[change + 1];
+            lowerResidual = residuals[change];
+            upperResidual = residuals[change + 1];
+            bracketed = true;
+            report.warmStarted = true;
+        }
+        break;
+    }
+    if (!bracketed) {
+        points = spread(searchMin, searchMax, true);
+        evaluateAll(points, residuals);
+        const int change = findSignChange(residuals);
+        if (change < 0) {
+            std::cerr << "Targeting: " << goalName(targeting.GOAL) << " - " << targeting.TARGET
+                << "     [" << searchMin << ", " << searchMax << "],  \n";
+            report.integratedSteps = totalSteps;
+            report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            return report;
+        }
+        lower = points[change];
+        upper = points[change + 1];
+        lowerResidual = residuals[change];
+        upperResidual = residuals[change + 1];
+    }
+
+    //  
+    auto width = [&]() { return upper - lower; };
+    auto tolerance = [&]() { return targeting.TOLERANCE * std::max(1.0, std::max(std::abs(lower), std::abs(upper))); };
+    while (width() > tolerance() && report.iterations < targeting.MAX_ITERATIONS) {
+        points = spread(lower, upper, false);
+        evaluateAll(points, residuals);
+        ++report.iterations;
+
+        points.insert(points.begin(), lower);
+        residuals.insert(residuals.begin(), lowerResidual);
+        points.push_back(upper);
+        residuals.push_back(upperResidual);
+        const int change = findSignChange(residuals);
+        lower = points[change];
+        upper = points[change + 1];
+        lowerResidual = residuals[change];
+        upperResidual = residuals[change + 1];
+    }
+    report.converged = width() <= tolerance();
+
+    //    -  ,     
+    report.value = 0.5 * (lower + upper);
+    if (std::isfinite(lowerResidual) && std::isfinite(upperResidual) && upperResidual != lowerResidual) {
+        report.value = std::min(upper, std::max(lower, lower - lowerResidual * (upper - lower) / (upperResidual - lowerResidual)));
+    }
+    long long steps = 0;
+    report.achieved = evaluate(params, targeting.VARIABLE, report.value, targeting.GOAL, targeting.TARGET, false, steps);
+    totalSteps += steps;
+    ++report.evaluations;
+    report.integratedSteps = totalSteps;
+
+    bool stored = false;
+    for (Solution& solution : m_solutions) {
+        if (solution.variable == targeting.VARIABLE && solution.goal == targeting.GOAL) {
+            solution.value = report.value;
+            stored = true;
+        }
+    }
+    if (!stored) m_solutions.push_back({ targeting.VARIABLE, targeting.GOAL, report.value });
+
+    report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Targeting: " << variableName(targeting.VARIABLE) << " = " << report.value << ", "
+        << goalName(targeting.GOAL) << " " << report.achieved << " ( " << targeting.TARGET << ")"
+        << (report.converged ? "" : " ( )") << ",  " << report.iterations
+        << ",  " << report.evaluations << ",  " << report.integratedSteps
+        << (report.warmStarted ? ",  " : "") << ",  " << report.seconds << " \n";
+    return report;
+}
@@ -0,0 +1,82 @@
+#ifndef TARGETINGSOLVER_H
+#define TARGETINGSOLVER_H
+
+#include <vector>
+
+#include "Calculations.h"
+
+//  
+enum class TargetingVariable {
+    InitialSpeed, // V0 -  vy
+    Thrust        // F - THRUST_COEFFICIENT
+};
+
+//   
+enum class TargetingGoal {
+    Period,        //   
+    FinalRadius,   // r    (  STEPS)
+    MinimumRadius  //  r    (, "   ")
+};
+
+struct TargetingParameters {
+    TargetingVariable VARIABLE = TargetingVariable::InitialSpeed;
+    TargetingGoal GOAL = TargetingGoal::Period;
+    double TARGET = 0.0;           //   (,   SimulationParameters)
+    double SEARCH_MIN = 0.0;       //   
+    double SEARCH_MAX = 1.0;
+    double TOLERANCE = 1e-9;       //    ( max(1, ||))
+    int MAX_ITERATIONS = 100;
+    unsigned int THREADS = 0;      // 0 -    
+};
+
+struct TargetingReport {
+    bool converged = false;
+    double value = 0.0;            //   
+    double achieved = 0.0;         //     ( )
+    int iterations = 0;
+    int evaluations = 0;           //   
+    long long integratedSteps = 0; //     (   )
+    bool warmStarted = false;
+    double seconds = 0.0;
+};
+
+//    :  ,     TARGET, 
+//  .        ( - TARGET)
+//   ( + 1) ,      ,
+//   ,   .   ,   ,
+//     (MinimumRadius - r   , Period -   ,
+//   - ),    .
+//
+//      [SEARCH_MIN, SEARCH_MAX].    
+//     ,   STEPS  - .
+//
+//    :         
+//           , 
+//       .
+class TargetingSolver {
+public:
+    TargetingSolver();
+
+    TargetingReport solve(const SimulationParameters& params, const TargetingParameters& targeting);
+
+    //    params  ,  value. earlyStop -   ,
+    //    ( - target) ;   ,   .
+    // steps -   .
+    static double evaluate(const SimulationParameters& params, TargetingVariable variable, double value,
+        TargetingGoal goal, double target, bool earlyStop, long long& steps);
+
+private:
+    //   ,       
+    static constexpr double WARM_START_FRACTION = 0.02;
+    //   ,   ,    
+    static constexpr int EVALUATION_CHUNK_STEPS = 2000;
+
+    struct Solution {
+        TargetingVariable variable;
+        TargetingGoal goal;
+        double value;
+    };
+    std::vector<Solution> m_solutions;
+};
+
+#endif // TARGETINGSOLVER_H
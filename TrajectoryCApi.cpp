@@ -0,0 +1,257 @@
+#include "TrajectoryCApi.h"
+#include "Calculations.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <vector>
+
+//      TrajectoryState*  
+static_assert(sizeof(TrajectoryState) == sizeof(State), "TrajectoryState    State");
+static_assert(offsetof(TrajectoryState, vy) == offsetof(State, vy), "TrajectoryState    State");
+
+struct TrajectorySimulation {
+    SimulationParameters params;
+    Calculations calculator;
+    int completedSteps = 0;
+    bool finished = false;
+
+    std::vector<State> states;     //  :    0
+    TrajectoryState* output = nullptr; //  ,  
+    size_t outputCapacity = 0;
+    size_t outputCount = 0;
+    //       :  ,    
+    // ,      
+    State outputLast = { 0.0, 0.0, 0.0, 0.0 };
+
+    std::vector<TrajectoryEvent> events;
+    double lastRadialVelocity = 0.0;
+
+    const State& lastState() const { return output ? outputLast : states.back(); }
+
+    void addEvent(int32_t type, int step, const State& state) {
+        TrajectoryEvent event;
+        event.structSize = sizeof(TrajectoryEvent);
+        event.type = type;
+        event.step = step;
+        event.time = step * params.DT;
+        event.state = { state.x, state.y, state.vx, state.vy };
+        events.push_back(event);
+    }
+
+    //  -     ,   OrbitAnalytics
+    void scanEvents(const State* newStates, size_t count, int firstStep) {
+        for (size_t i = 0; i < count; ++i) {
+            const State& s = newStates[i];
+            const double radialVelocity = s.x * s.vx + s.y * s.vy;
+            const int step = firstStep + static_cast<int>(i);
+            if (lastRadialVelocity < 0.0 && radialVelocity >= 0.0) addEvent(TRAJECTORY_EVENT_PERIAPSIS, step, s);
+            if (lastRadialVelocity > 0.0 && radialVelocity <= 0.0) addEvent(TRAJECTORY_EVENT_APOAPSIS, step, s);
+            lastRadialVelocity = radialVelocity;
+        }
+    }
+};
+
+namespace {
+//      extern "C":     
+template <typename Fn>
+int guarded(Fn fn) {
+    try {
+        return fn();
+    }
+    catch (const std::bad_alloc&) {
+        return TRAJECTORY_ERROR_MEMORY;
+    }
+    catch (...) {
+        return TRAJECTORY_ERROR_INTERNAL;
+    }
+}
+
+//    TrajectoryParameters:   create  
+const size_t PARAMETERS_V1_SIZE = offsetof(TrajectoryParameters, analyticKepler) + sizeof(int32_t);
+
+TrajectoryParameters defaultParameters() {
+    const SimulationParameters defaults;
+    TrajectoryParameters params;
+    params.structSize = sizeof(TrajectoryParameters);
+    params.G = defaults.G;
+    params.M = defaults.M;
+    params.centralBodyRadius = defaults.CENTRAL_BODY_RADIUS;
+    params.dragCoefficient = defaults.DRAG_COEFFICIENT;
+    params.thrustCoefficient = defaults.THRUST_COEFFICIENT;
+    params.dt = defaults.DT;
+    params.steps = defaults.STEPS;
+    params.precision = static_cast<int32_t>(defaults.PRECISION);
+    params.initialState = { defaults.initialState.x, defaults.initialState.y, defaults.initialState.vx, defaults.initialState.vy };
+    params.sundmanStep = defaults.SUNDMAN_STEP;
+    params.analyticKepler = defaults.ANALYTIC_KEPLER ? 1 : 0;
+    return params;
+}
+
+//         structSize ;  structSize  
+template <typename T>
+void copyToCaller(T* target, const T& source) {
+    const size_t size = std::min<size_t>(target->structSize, sizeof(T));
+    if (size > sizeof(uint32_t)) {
+        std::memcpy(reinterpret_cast<char*>(target) + sizeof(uint32_t),
+                    reinterpret_cast<const char*>(&source) + sizeof(uint32_t), size - sizeof(uint32_t));
+    }
+}
+}
+
+uint32_t trajectory_api_version(void) {
+    return TRAJECTORY_API_VERSION;
+}
+
+int trajectory_default_parameters(TrajectoryParameters* params) {
+    if (!params || params->structSize < sizeof(uint32_t)) return TRAJECTORY_ERROR_ARGUMENT;
+    copyToCaller(params, defaultParameters());
+    return TRAJECTORY_OK;
+}
+
+TrajectorySimulation* trajectory_create(const TrajectoryParameters* callerParams) {
+    if (!callerParams || callerParams->structSize < PARAMETERS_V1_SIZE) return nullptr;
+    // ,     ,   
+    TrajectoryParameters given = defaultParameters();
+    std::memcpy(&given, callerParams, std::min<size_t>(callerParams->structSize, sizeof(TrajectoryParameters)));
+    const TrajectoryParameters* params = &given;
+    if (!(params->dt > 0.0) || params->steps < 0 ||
+        params->precision < TRAJECTORY_PRECISION_FLOAT || params->precision > TRAJECTORY_PRECISION_KAHAN) {
+        return nullptr;
+    }
+    try {
+        std::unique_ptr<TrajectorySimulation> simulation(new TrajectorySimulation());
+        SimulationParameters& p = simulation->params;
+        simulation->calculator.setVerbose(false); // stdout  -
+        p.G = params->G;
+        p.M = params->M;
+        p.CENTRAL_BODY_RADIUS = params->centralBodyRadius;
+        p.DRAG_COEFFICIENT = params->dragCoefficient;
+        p.THRUST_COEFFICIENT = params->thrustCoefficient;
+        p.DT = params->dt;
+        p.STEPS = params->steps;
+        p.PRECISION = static_cast<Precision>(params->precision);
+        p.initialState.x = params->initialState.x;
+        p.initialState.y = params->initialState.y;
+        p.initialState.vx = params->initialState.vx;
+        p.initialState.vy = params->initialState.vy;
+        p.SUNDMAN_STEP = params->sundmanStep;
+        p.ANALYTIC_KEPLER = params->analyticKepler != 0;
+
+        //  0     -   Calculations::runSimulation
+        SimulationParameters initialOnly = p;
+        initialOnly.STEPS = 0;
+        simulation->calculator.runSimulation(initialOnly, simulation->states);
+        const State& start = simulation->states.front();
+        simulation->lastRadialVelocity = start.x * start.vx + start.y * start.vy;
+        if (start.x * start.x + start.y * start.y < p.CENTRAL_BODY_RADIUS * p.CENTRAL_BODY_RADIUS) {
+            simulation->finished = true;
+            simulation->addEvent(TRAJECTORY_EVENT_COLLISION, 0, start);
+        }
+        else if (p.STEPS == 0) {
+            simulation->finished = true;
+        }
+        return simulation.release();
+    }
+    catch (...) {
+        return nullptr;
+    }
+}
+
+void trajectory_destroy(TrajectorySimulation* simulation) {
+    delete simulation;
+}
+
+int trajectory_set_output_buffer(TrajectorySimulation* simulation, TrajectoryState* buffer, size_t capacity) {
+    if (!simulation || (buffer && capacity == 0)) return TRAJECTORY_ERROR_ARGUMENT;
+    return guarded([&]() {
+        const State last = simulation->lastState();
+        if (!buffer && simulation->output) {
+            // ,  ,     
+            simulation->states.assign(1, last);
+        }
+        simulation->output = buffer;
+        simulation->outputCapacity = buffer ? capacity : 0;
+        simulation->outputCount = 0;
+        simulation->outputLast = last;
+        return TRAJECTORY_OK;
+    });
+}
+
+size_t trajectory_output_count(const TrajectorySimulation* simulation) {
+    return simulation ? simulation->outputCount : 0;
+}
+
+int trajectory_step(TrajectorySimulation* simulation, int32_t maxSteps, int32_t* stepsDone) {
+    if (stepsDone) *stepsDone = 0;
+    if (!simulation || maxSteps < 0) return TRAJECTORY_ERROR_ARGUMENT;
+    if (simulation->finished) return TRAJECTORY_FINISHED;
+    return guarded([&]() {
+        int steps = std::min(maxSteps, simulation->params.STEPS - simulation->completedSteps);
+        if (simulation->output) {
+            const size_t room = simulation->outputCapacity - simulation->outputCount;
+            if (room == 0) return TRAJECTORY_ERROR_BUFFER_FULL;
+            steps = static_cast<int>(std::min<size_t>(static_cast<size_t>(steps), room));
+        }
+        if (steps == 0) return TRAJECTORY_OK;
+
+        const int firstStep = simulation->completedSteps;
+        bool collided = false;
+        size_t produced = 0;
+        if (simulation->output) {
+            //      ,   
+            State* target = reinterpret_cast<State*>(simulation->output + simulation->outputCount);
+            collided = simulation->calculator.continueSimulation(simulation->params, simulation->outputLast,
+                firstStep, firstStep + steps, target, produced);
+            simulation->outputCount += produced;
+            if (produced > 0) simulation->outputLast = target[produced - 1];
+            simulation->completedSteps += static_cast<int>(produced);
+            simulation->scanEvents(target, produced, firstStep + 1);
+        }
+        else {
+            std::vector<State>& states = simulation->states;
+            //   : Calculations   ,  
+            //        
+            const size_t needed = states.size() + static_cast<size_t>(steps);
+            if (states.capacity() < needed) states.reserve(std::max(needed, 2 * states.capacity()));
+            const size_t before = states.size();
+            collided = simulation->calculator.continueSimulation(simulation->params, firstStep,
+                firstStep + steps, states);
+            produced = states.size() - before;
+            simulation->completedSteps += static_cast<int>(produced);
+            simulation->scanEvents(states.data() + before, produced, firstStep + 1);
+        }
+        if (stepsDone) *stepsDone = static_cast<int32_t>(produced);
+        if (collided) {
+            simulation->addEvent(TRAJECTORY_EVENT_COLLISION, simulation->completedSteps, simulation->lastState());
+        }
+        simulation->finished = collided || simulation->completedSteps >= simulation->params.STEPS;
+        return simulation->finished ? TRAJECTORY_FINISHED : TRAJECTORY_OK;
+    });
+}
+
+int32_t trajectory_completed_steps(const TrajectorySimulation* simulation) {
+    return simulation ? simulation->completedSteps : 0;
+}
+
+int trajectory_get_states(const TrajectorySimulation* simulation, const TrajectoryState** states, size_t* count) {
+    if (!simulation || !states || !count) return TRAJECTORY_ERROR_ARGUMENT;
+    *states = reinterpret_cast<const TrajectoryState*>(simulation->states.data());
+    *count = simulation->states.size();
+    return TRAJECTORY_OK;
+}
+
+size_t trajectory_event_count(const TrajectorySimulation* simulation) {
+    return simulation ? simulation->events.size() : 0;
+}
+
+int trajectory_get_event(const TrajectorySimulation* simulation, size_t index, TrajectoryEvent* event) {
+    if (!simulation || !event || index >= simulation->events.size() ||
+        event->structSize < offsetof(TrajectoryEvent, state) + sizeof(TrajectoryState)) {
+        return TRAJECTORY_ERROR_ARGUMENT;
+    }
+    copyToCaller(event, simulation->events[index]);
+    return TRAJECTORY_OK;
+}
@@ -0,0 +1,120 @@
+#ifndef TRAJECTORYCAPI_H
+#define TRAJECTORYCAPI_H
+
+/* C-  ( trajectory_c)     .
+ *
+ *   trajectory_create    trajectory_step. :
+ *   -   ( ): trajectory_get_states     
+ *       ,  .    
+ *     trajectory_step  trajectory_destroy;
+ *   -   (trajectory_set_output_buffer):     ,
+ *     trajectory_step     .
+ *  ,  trajectory_api_version  trajectory_default_parameters, 
+ * ,  trajectory_create;        .
+ *  :     ,  - TRAJECTORY_API_VERSION.
+ *    - structSize:     sizeof ,  
+ *  .      ,   structSize; , 
+ *   ,   . */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(TRAJECTORY_C_API_BUILD)
+#    define TRAJECTORY_API __declspec(dllexport)
+#  else
+#    define TRAJECTORY_API __declspec(dllimport)
+#  endif
+#else
+#  define TRAJECTORY_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRAJECTORY_API_VERSION 1
+
+/*   */
+#define TRAJECTORY_OK 0
+#define TRAJECTORY_FINISHED 1            /*        */
+#define TRAJECTORY_ERROR_ARGUMENT (-1)
+#define TRAJECTORY_ERROR_BUFFER_FULL (-2)
+#define TRAJECTORY_ERROR_MEMORY (-3)     /*   ;     */
+#define TRAJECTORY_ERROR_INTERNAL (-4)   /*   .  C++    */
+
+/*  -  enum Precision */
+#define TRAJECTORY_PRECISION_FLOAT 0
+#define TRAJECTORY_PRECISION_DOUBLE 1
+#define TRAJECTORY_PRECISION_LONG_DOUBLE 2
+#define TRAJECTORY_PRECISION_KAHAN 3
+
+/*  */
+#define TRAJECTORY_EVENT_PERIAPSIS 1
+#define TRAJECTORY_EVENT_APOAPSIS 2
+#define TRAJECTORY_EVENT_COLLISION 3
+
+/*     State: x, y, vx, vy */
+typedef struct TrajectoryState {
+    double x, y, vx, vy;
+} TrajectoryState;
+
+typedef struct TrajectoryParameters {
+    uint32_t structSize;     /* sizeof(TrajectoryParameters)   */
+    double G;
+    double M;
+    double centralBodyRadius;
+    double dragCoefficient;
+    double thrustCoefficient;
+    double dt;
+    int32_t steps;
+    int32_t precision;       /* TRAJECTORY_PRECISION_* */
+    TrajectoryState initialState;
+    double sundmanStep;      /* 0 -   */
+    int32_t analyticKepler;  /* 0 -  4 */
+} TrajectoryParameters;
+
+typedef struct TrajectoryEvent {
+    uint32_t structSize;     /* sizeof(TrajectoryEvent)   */
+    int32_t type;            /* TRAJECTORY_EVENT_* */
+    int32_t step;            /*  ,     */
+    double time;             /* step * dt */
+    TrajectoryState state;
+} TrajectoryEvent;
+
+typedef struct TrajectorySimulation TrajectorySimulation;
+
+TRAJECTORY_API uint32_t trajectory_api_version(void);
+/*   ,   SimulationParameters. params->structSize   */
+TRAJECTORY_API int trajectory_default_parameters(TrajectoryParameters* params);
+
+/* NULL    ( .. structSize    )   .
+ *       ( 0) */
+TRAJECTORY_API TrajectorySimulation* trajectory_create(const TrajectoryParameters* params);
+TRAJECTORY_API void trajectory_destroy(TrajectorySimulation* simulation);
+
+/*     buffer[0..capacity); buffer = NULL -    .
+ * ,     ,  ;    
+ *      . */
+TRAJECTORY_API int trajectory_set_output_buffer(TrajectorySimulation* simulation, TrajectoryState* buffer, size_t capacity);
+/*         trajectory_set_output_buffer */
+TRAJECTORY_API size_t trajectory_output_count(const TrajectorySimulation* simulation);
+
+/*   maxSteps . stepsDone (  NULL) -  .
+ * TRAJECTORY_OK -  , TRAJECTORY_FINISHED -  ,
+ * TRAJECTORY_ERROR_BUFFER_FULL -     . */
+TRAJECTORY_API int trajectory_step(TrajectorySimulation* simulation, int32_t maxSteps, int32_t* stepsDone);
+TRAJECTORY_API int32_t trajectory_completed_steps(const TrajectorySimulation* simulation);
+
+/*  :       0   ,   */
+TRAJECTORY_API int trajectory_get_states(const TrajectorySimulation* simulation, const TrajectoryState** states, size_t* count);
+
+TRAJECTORY_API size_t trajectory_event_count(const TrajectorySimulation* simulation);
+/* event->structSize   */
+TRAJECTORY_API int trajectory_get_event(const TrajectorySimulation* simulation, size_t index, TrajectoryEvent* event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TRAJECTORYCAPI_H */
@@ -0,0 +1,217 @@
+#include "TrajectoryPager.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace {
+bool intersects(const ChunkedTrajectoryFile::ChunkInfo& chunk, const PointBounds& view) {
+    return chunk.maxX >= view.minX && chunk.minX <= view.maxX && chunk.maxY >= view.minY && chunk.minY <= view.maxY;
+}
+}
+
+TrajectoryPager::TrajectoryPager()
+    : m_pointCount(0),
+    m_dt(0.0),
+    m_windowFirst(0),
+    m_windowLast(0),
+    m_cacheBytes(0),
+    m_stopWorker(false),
+    m_hasUpdates(false) {
+}
+
+TrajectoryPager::~TrajectoryPager() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopWorker = true;
+    }
+    m_wakeWorker.notify_all();
+    if (m_worker.joinable()) m_worker.join();
+}
+
+bool TrajectoryPager::open(const std::string& path) {
+    if (m_worker.joinable()) {
+        std::cerr << "TrajectoryPager:   \n";
+        return false;
+    }
+    if (!m_reader.open(path)) return false;
+    m_index = m_reader.getIndex();
+    m_pointCount = m_reader.getPointCount();
+    m_dt = m_reader.getTimeStep();
+    m_windowFirst = 0;
+    m_windowLast = m_pointCount > 0 ? m_pointCount - 1 : 0;
+    m_worker = std::thread(&TrajectoryPager::workerLoop, this);
+    std::cout << "TrajectoryPager: " << path << " - " << m_pointCount << " , "
+        << m_index.size() << " \n";
+    return true;
+}
+
+void TrajectoryPager::setTimeWindow(uint64_t first, uint64_t last) {
+    m_windowFirst = std::min(first, last);
+    m_windowLast = std::max(first, last);
+}
+
+TrajectoryPager::ChunkData TrajectoryPager::findCached(const ChunkKey& key) {
+    auto it = m_cache.find(key);
+    if (it == m_cache.end()) return ChunkData();
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return it->second->data;
+}
+
+bool TrajectoryPager::assemble(const PointBounds& view, size_t pointBudget, WorldPointsSoA& out,
+    std::vector<size_t>& seamPoints) {
+    out.clear();
+    seamPoints.clear();
+    if (m_index.empty() || m_pointCount == 0) return true;
+
+    // 1.       ,     
+    std::vector<size_t> selected;
+    uint64_t selectedPoints = 0;
+    for (size_t i = 0; i < m_index.size(); ++i) {
+        const auto& chunk = m_index[i];
+        uint64_t first = std::max<uint64_t>(chunk.firstIndex, m_windowFirst);
+        uint64_t last = std::min<uint64_t>(chunk.firstIndex + chunk.count - 1, m_windowLast);
+        if (first > last || !intersects(chunk, view)) continue;
+        selected.push_back(i);
+        selectedPoints += last - first + 1;
+    }
+
+    // 2. :   ,     ,
+    //         
+    const uint64_t targetStride = std::max<uint64_t>(1, (selectedPoints + pointBudget - 1) / std::max<size_t>(1, pointBudget));
+    uint32_t level = 0;
+    while (level + 1 < ChunkedTrajectoryFile::LOD_LEVELS && ChunkedTrajectoryFile::levelStep(level + 1) <= targetStride) {
+        ++level;
+    }
+    const uint64_t extraStride = std::max<uint64_t>(1, targetStride / ChunkedTrajectoryFile::levelStep(level));
+
+    // 3.   .    ,     
+    std::vector<ChunkKey> required;
+    bool complete = true;
+    size_t previousChunk = static_cast<size_t>(-1);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (size_t i : selected) {
+            const auto& chunk = m_index[i];
+            ChunkKey key(i, level);
+            uint32_t usedLevel = level;
+            uint64_t stride = extraStride;
+            ChunkData data = findCached(key);
+            if (!data) {
+                required.push_back(key);
+                complete = false;
+                for (uint32_t coarser = level + 1; coarser < ChunkedTrajectoryFile::LOD_LEVELS && !data; ++coarser) {
+                    data = findCached(ChunkKey(i, coarser));
+                    usedLevel = coarser;
+                    stride = 1;
+                }
+                if (!data) continue; //         -    
+            }
+
+            const size_t levelCount = data->size();
+            bool firstPointOfChunk = true;
+            for (size_t j = 0; j < levelCount; ) {
+                uint64_t index = chunk.firstIndex + ChunkedTrajectoryFile::levelPointOffset(chunk, usedLevel, static_cast<uint32_t>(j));
+                if (index >= m_windowFirst && index <= m_windowLast) {
+                    if (firstPointOfChunk && previousChunk + 1 != i && out.size() > 0) {
+                        // :          
+                        seamPoints.push_back(out.size());
+                        out.x.push_back(out.x.back());
+                        out.y.push_back(out.y.back());
+                        seamPoints.push_back(out.size());
+                        out.x.push_back(data->x[j]);
+                        out.y.push_back(data->y[j]);
+                    }
+                    firstPointOfChunk = false;
+                    out.x.push_back(data->x[j]);
+                    out.y.push_back(data->y[j]);
+                }
+                //     ,     
+                if (j + 1 == levelCount) break;
+                j = static_cast<size_t>(std::min<uint64_t>(j + stride, levelCount - 1));
+            }
+            if (!firstPointOfChunk) previousChunk = i;
+        }
+    }
+
+    // 4.       -    
+    std::vector<ChunkKey> prefetch;
+    const float marginX = view.maxX - view.minX;
+    const float marginY = view.maxY - view.minY;
+    const PointBounds around = { view.minX - marginX, view.maxX + marginX, view.minY - marginY, view.maxY + marginY };
+    for (size_t i = 0; i < m_index.size(); ++i) {
+        const auto& chunk = m_index[i];
+        if (chunk.firstIndex > m_windowLast || chunk.firstIndex + chunk.count - 1 < m_windowFirst) continue;
+        if (intersects(chunk, around) && !intersects(chunk, view)) prefetch.push_back(ChunkKey(i, level));
+    }
+    enqueue(required, prefetch);
+    return complete;
+}
+
+void TrajectoryPager::enqueue(const std::vector<ChunkKey>& required, const std::vector<ChunkKey>& prefetch) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        //   -     
+        m_queue.clear();
+        m_queued.clear();
+        for (const auto& key : required) {
+            if (m_queued.insert(key).second) m_queue.push_back(key);
+        }
+        for (const auto& key : prefetch) {
+            if (m_cache.count(key) == 0 && m_queued.insert(key).second) m_queue.push_back(key);
+        }
+        m_required.clear();
+        m_required.insert(required.begin(), required.end());
+    }
+    m_wakeWorker.notify_one();
+}
+
+bool TrajectoryPager::consumeUpdates() {
+    return m_hasUpdates.exchange(false);
+}
+
+bool TrajectoryPager::isLoading() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_required.empty();
+}
+
+void TrajectoryPager::workerLoop() {
+    std::vector<float> x, y;
+    for (;;) {
+        ChunkKey key;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeWorker.wait(lock, [this]() { return m_stopWorker || !m_queue.empty(); });
+            if (m_stopWorker) return;
+            key = m_queue.front();
+            m_queue.pop_front();
+            m_queued.erase(key);
+            if (m_cache.count(key) != 0) continue;
+        }
+
+        //    -  ,         
+        bool ok = m_reader.readLevel(key.first, key.second, x, y);
+        std::shared_ptr<WorldPointsSoA> data = std::make_shared<WorldPointsSoA>();
+        if (ok) {
+            data->x = x;
+            data->y = y;
+        }
+        else {
+            std::cerr << "TrajectoryPager:     " << key.first << "\n";
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (ok) {
+            m_lru.push_front({ key, data });
+            m_cache[key] = m_lru.begin();
+            m_cacheBytes += data->size() * 2 * sizeof(float);
+            while (m_cacheBytes > CACHE_MAX_BYTES && m_lru.size() > 1) {
+                const CacheEntry& last = m_lru.back();
+                m_cacheBytes -= last.data->size() * 2 * sizeof(float);
+                m_cache.erase(last.key);
+                m_lru.pop_back();
+            }
+        }
+        //       ,  isLoading()   false 
+        if (m_required.erase(key) != 0) m_hasUpdates = true;
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef TRAJECTORYPAGER_H
+#define TRAJECTORYPAGER_H
+
+#include <vector>
+#include <string>
+#include <list>
+#include <deque>
+#include <map>
+#include <set>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+#include "ChunkedTrajectoryFile.h"
+#include "ScreenProjection.h" // WorldPointsSoA, PointBounds
+
+//    ChunkedTrajectoryFile  TrajectoryVisualizer.
+//           , 
+//  (      pointBudget )     .
+//  ,      (    )
+//   ;    consumeUpdates()  true.
+class TrajectoryPager {
+public:
+    TrajectoryPager();
+    ~TrajectoryPager();
+
+    bool open(const std::string& path);
+    uint64_t getPointCount() const { return m_pointCount; }
+    double getTimeStep() const { return m_dt; }
+
+    //    [first, last],   -  
+    void setTimeWindow(uint64_t first, uint64_t last);
+
+    //   out  ,   view ( ).
+    //        ,    out
+    //   seamPoints -   LineStrip    .
+    //  true,         .
+    bool assemble(const PointBounds& view, size_t pointBudget, WorldPointsSoA& out, std::vector<size_t>& seamPoints);
+
+    // true,         
+    bool consumeUpdates();
+    bool isLoading() const;
+
+private:
+    static constexpr size_t CACHE_MAX_BYTES = size_t(512) * 1024 * 1024;
+
+    typedef std::pair<size_t, uint32_t> ChunkKey; // (, )
+    typedef std::shared_ptr<const WorldPointsSoA> ChunkData;
+
+    struct CacheEntry {
+        ChunkKey key;
+        ChunkData data;
+    };
+
+    ChunkData findCached(const ChunkKey& key); //   m_mutex
+    void enqueue(const std::vector<ChunkKey>& required, const std::vector<ChunkKey>& prefetch);
+    void workerLoop();
+
+    ChunkedTrajectoryReader m_reader; //     ( )
+    std::vector<ChunkedTrajectoryFile::ChunkInfo> m_index;
+    uint64_t m_pointCount;
+    double m_dt;
+    uint64_t m_windowFirst;
+    uint64_t m_windowLast;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wakeWorker;
+    std::deque<ChunkKey> m_queue;
+    std::set<ChunkKey> m_queued;
+    std::list<CacheEntry> m_lru;
+    std::map<ChunkKey, std::list<CacheEntry>::iterator> m_cache;
+    size_t m_cacheBytes;
+    std::set<ChunkKey> m_required; // ,     
+    bool m_stopWorker;
+    std::atomic<bool> m_hasUpdates;
+    std::thread m_worker;
+};
+
+#endif // TRAJECTORYPAGER_H
@@ -0,0 +1,142 @@
+#include "TrajectorySpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+constexpr size_t TrajectorySpatialIndex::NO_POINT;
+
+TrajectorySpatialIndex::TrajectorySpatialIndex()
+    : m_bounds{ 0.f, -1.f, 0.f, -1.f },
+    m_cellSize(1.f),
+    m_inverseCellSize(1.f),
+    m_cellsX(0),
+    m_cellsY(0) {
+}
+
+void TrajectorySpatialIndex::clear() {
+    m_bounds = { 0.f, -1.f, 0.f, -1.f };
+    m_cellsX = m_cellsY = 0;
+    m_cellStart.clear();
+    m_pointIndex.clear();
+}
+
+long long TrajectorySpatialIndex::cellCoordX(float x) const {
+    return static_cast<long long>(std::floor((x - m_bounds.minX) * m_inverseCellSize));
+}
+
+long long TrajectorySpatialIndex::cellCoordY(float y) const {
+    return static_cast<long long>(std::floor((y - m_bounds.minY) * m_inverseCellSize));
+}
+
+void TrajectorySpatialIndex::build(const WorldPointsSoA& points) {
+    clear();
+    const size_t count = points.size();
+    if (count == 0 || count > std::numeric_limits<uint32_t>::max()) return;
+
+    m_bounds = ScreenProjection::computeBounds(points);
+    const double width = static_cast<double>(m_bounds.maxX) - m_bounds.minX;
+    const double height = static_cast<double>(m_bounds.maxY) - m_bounds.minY;
+    const double targetCells = static_cast<double>(std::min(MAX_CELLS, std::max<size_t>(1, count / POINTS_PER_CELL)));
+
+    //  :   /  .  
+    // (   ) -  /  
+    double cellSize = (width > 0.0 && height > 0.0) ? std::sqrt(width * height / targetCells)
+        : std::max(width, height) / targetCells;
+    if (!(cellSize > 0.0)) cellSize = 1.0;
+    m_cellSize = static_cast<float>(cellSize);
+    m_inverseCellSize = static_cast<float>(1.0 / cellSize);
+    m_cellsX = static_cast<uint32_t>(std::min(targetCells, std::floor(width / cellSize) + 1.0));
+    m_cellsY = static_cast<uint32_t>(std::min(targetCells, std::floor(height / cellSize) + 1.0));
+
+    //  :   ,   
+    std::vector<uint32_t> cellOfPoint(count);
+    m_cellStart.assign(static_cast<size_t>(m_cellsX) * m_cellsY + 1, 0);
+    for (size_t i = 0; i < count; ++i) {
+        long long cx = std::min<long long>(std::max<long long>(cellCoordX(points.x[i]), 0), m_cellsX - 1);
+        long long cy = std::min<long long>(std::max<long long>(cellCoordY(points.y[i]), 0), m_cellsY - 1);
+        cellOfPoint[i] = static_cast<uint32_t>(cy * m_cellsX + cx);
+        ++m_cellStart[cellOfPoint[i] + 1];
+    }
+    for (size_t c = 1; c < m_cellStart.size(); ++c) {
+        m_cellStart[c] += m_cellStart[c - 1];
+    }
+    m_pointIndex.resize(count);
+    std::vector<uint32_t> fill(m_cellStart.begin(), m_cellStart.end() - 1);
+    for (size_t i = 0; i < count; ++i) {
+        m_pointIndex[fill[cellOfPoint[i]]++] = static_cast<uint32_t>(i);
+    }
+}
+
+size_t TrajectorySpatialIndex::nearest(const WorldPointsSoA& points, float x, float y, float maxDistance,
+    size_t indexLimit) const {
+    if (isEmpty() || !(maxDistance >= 0.f)) return NO_POINT;
+
+    const long long cx = cellCoordX(x);
+    const long long cy = cellCoordY(y);
+    //        maxDistance 
+    // (     )
+    const double ringLimit = std::ceil(static_cast<double>(maxDistance) * m_inverseCellSize) + 1.0;
+    const long long gridReach = std::max(std::max(std::abs(cx), std::abs(cx - m_cellsX)), std::max(std::abs(cy), std::abs(cy - m_cellsY)));
+    const long long maxRing = ringLimit < static_cast<double>(gridReach) ? static_cast<long long>(ringLimit) : gridReach;
+
+    size_t best = NO_POINT;
+    float bestDistanceSquared = maxDistance * maxDistance;
+    //     (cx, cy):  k -    k  .
+    //   k   (k - 1) * m_cellSize,     
+    for (long long k = 0; k <= maxRing; ++k) {
+        if (best != NO_POINT) {
+            float ringDistance = (k - 1) * m_cellSize;
+            if (ringDistance > 0.f && ringDistance * ringDistance > bestDistanceSquared) break;
+        }
+        const long long minCellX = std::max<long long>(cx - k, 0), maxCellX = std::min<long long>(cx + k, m_cellsX - 1);
+        const long long minCellY = std::max<long long>(cy - k, 0), maxCellY = std::min<long long>(cy + k, m_cellsY - 1);
+        if (minCellX > maxCellX || minCellY > maxCellY) continue; //    
+        for (long long j = minCellY; j <= maxCellY; ++j) {
+            const bool edgeRow = (j == cy - k || j == cy + k);
+            for (long long i = minCellX; i <= maxCellX; ++i) {
+                if (!edgeRow && i != cx - k && i != cx + k) {
+                    i = cx + k - 1; //       
+                    continue;
+                }
+                const size_t cell = static_cast<size_t>(j * m_cellsX + i);
+                for (uint32_t n = m_cellStart[cell]; n < m_cellStart[cell + 1]; ++n) {
+                    const uint32_t index = m_pointIndex[n];
+                    if (index >= indexLimit) continue;
+                    const float dx = points.x[index] - x;
+                    const float dy = points.y[index] - y;
+                    const float distanceSquared = dx * dx + dy * dy;
+                    if (distanceSquared < bestDistanceSquared || (distanceSquared == bestDistanceSquared && best == NO_POINT)) {
+                        bestDistanceSquared = distanceSquared;
+                        best = index;
+                    }
+                }
+            }
+        }
+    }
+    return best;
+}
+
+void TrajectorySpatialIndex::queryRect(const WorldPointsSoA& points, const PointBounds& rect, size_t indexLimit,
+    std::vector<uint32_t>& result) const {
+    result.clear();
+    if (isEmpty() || rect.isEmpty() || rect.minY > rect.maxY) return;
+
+    const long long minCellX = std::max<long long>(cellCoordX(rect.minX), 0);
+    const long long maxCellX = std::min<long long>(cellCoordX(rect.maxX), m_cellsX - 1);
+    const long long minCellY = std::max<long long>(cellCoordY(rect.minY), 0);
+    const long long maxCellY = std::min<long long>(cellCoordY(rect.maxY), m_cellsY - 1);
+    for (long long j = minCellY; j <= maxCellY; ++j) {
+        for (long long i = minCellX; i <= maxCellX; ++i) {
+            const size_t cell = static_cast<size_t>(j * m_cellsX + i);
+            for (uint32_t n = m_cellStart[cell]; n < m_cellStart[cell + 1]; ++n) {
+                const uint32_t index = m_pointIndex[n];
+                const float px = points.x[index], py = points.y[index];
+                if (index < indexLimit && px >= rect.minX && px <= rect.maxX && py >= rect.minY && py <= rect.maxY) {
+                    result.push_back(index);
+                }
+            }
+        }
+    }
+    std::sort(result.begin(), result.end()); //   ,    
+}
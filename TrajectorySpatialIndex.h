@@ -0,0 +1,49 @@
+#ifndef TRAJECTORYSPATIALINDEX_H
+#define TRAJECTORYSPATIALINDEX_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "ScreenProjection.h" // WorldPointsSoA, PointBounds
+
+//           :
+//   (  )      ( ).
+//  ,   POINTS_PER_CELL   .   
+//    ( ),   - O(n),  
+//         .
+//
+//    :      WorldPointsSoA,    .
+class TrajectorySpatialIndex {
+public:
+    static constexpr size_t NO_POINT = static_cast<size_t>(-1);
+
+    TrajectorySpatialIndex();
+
+    void build(const WorldPointsSoA& points);
+    void clear();
+    bool isEmpty() const { return m_pointIndex.empty(); }
+
+    //   (x, y)    indexLimit,   maxDistance. NO_POINT,   
+    size_t nearest(const WorldPointsSoA& points, float x, float y, float maxDistance, size_t indexLimit) const;
+
+    //     indexLimit,   rect,  
+    void queryRect(const WorldPointsSoA& points, const PointBounds& rect, size_t indexLimit,
+        std::vector<uint32_t>& result) const;
+
+private:
+    static constexpr size_t POINTS_PER_CELL = 4;
+    static constexpr size_t MAX_CELLS = size_t(1) << 24;
+
+    long long cellCoordX(float x) const;
+    long long cellCoordY(float y) const;
+
+    PointBounds m_bounds;
+    float m_cellSize;
+    float m_inverseCellSize;
+    uint32_t m_cellsX, m_cellsY;
+    std::vector<uint32_t> m_cellStart;  //   c: m_pointIndex[m_cellStart[c] .. m_cellStart[c + 1])
+    std::vector<uint32_t> m_pointIndex;
+};
+
+#endif // TRAJECTORYSPATIALINDEX_H
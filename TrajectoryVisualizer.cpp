@@ -8,8 +8,29 @@
 // const unsigned int TrajectoryVisualizer::DEFAULT_POINTS_PER_FRAME = 1u; 
 // ...      ...
 
+namespace {
+//    :  ,   ,  -     
+const sf::Color TRAJECTORY_PALETTE[] = {
+    sf::Color::White,
+    sf::Color(0, 200, 255),
+    sf::Color(255, 100, 100),
+    sf::Color(120, 230, 120),
+    sf::Color(255, 170, 0),
+    sf::Color(200, 120, 255),
+    sf::Color(255, 105, 180),
+    sf::Color(230, 230, 90),
+    sf::Color(0, 190, 160),
+    sf::Color(160, 160, 255)
+};
+const size_t TRAJECTORY_PALETTE_SIZE = sizeof(TRAJECTORY_PALETTE) / sizeof(TRAJECTORY_PALETTE[0]);
+const sf::Color UNCERTAINTY_ELLIPSE_COLOR(0, 255, 255, 180);
+}
+
 TrajectoryVisualizer::TrajectoryVisualizer(unsigned int width, unsigned int height, const std::string& windowTitle)
-    : m_window(sf::VideoMode(width, height), windowTitle, sf::Style::Default), //  L""    ,  
+    : m_windowHandle(ResourceCache::instance().acquireWindow(width, height, windowTitle)),
+    m_window(*m_windowHandle),
+    m_closeRequested(false),
+    m_maxVisiblePoints(0),
     m_scale(DEFAULT_SCALE),
     m_offset(0.f, 0.f),
     m_screenCenter(static_cast<float>(width) / 2.f, static_cast<float>(height) / 2.f),
@@ -17,13 +38,39 @@ TrajectoryVisualizer::TrajectoryVisualizer(unsigned int width, unsigned int heig
     m_pointsPerFrame(DEFAULT_POINTS_PER_FRAME),
     m_isPaused(false),
     m_showAllPointsImmediately(false),
-    m_isDragging(false) {
+    m_heatmapMode(false),
+    m_heatmapDirty(true),
+    m_heatmapBinnedPoints(0),
+    m_heatmapMaxDensity(0),
+    m_sampleStates(nullptr),
+    m_sampleTimeStep(0.0),
+    m_hoverLayer(0),
+    m_hoverPoint(TrajectorySpatialIndex::NO_POINT),
+    m_isSelecting(false),
+    m_selectedCount(0),
+    m_showEllipses(true),
+    m_hudDirty(true),
+    m_isDragging(false),
+    m_onDemandRendering(true),
+    m_needsRedraw(true) {
     m_window.setFramerateLimit(60);
     setupInfoText();
 }
 
+TrajectoryVisualizer::~TrajectoryVisualizer() {
+    ResourceCache::instance().releaseWindow(std::move(m_windowHandle));
+}
+
+void TrajectoryVisualizer::closeWindow() {
+    m_closeRequested = true;
+    m_window.setVisible(false); //  ,      
+}
+
 void TrajectoryVisualizer::setData(const WorldTrajectoryData& data) {
-    m_worldTrajectoryData = data;
+    m_pager.reset();
+    m_trajectories.clear();
+    clearPicking();
+    m_trajectories.push_back(makeLayer(data, paletteColor(0)));
     resetViewAndAnimation();
     // recalculateScreenTrajectory(); //   resetViewAndAnimation
 }
@@ -56,44 +103,147 @@ bool TrajectoryVisualizer::loadDataFromFile(const std::string& filename) {
 }
 
 void TrajectoryVisualizer::run() {
-    if (m_worldTrajectoryData.empty()) {
+    if (m_closeRequested) { //  run()  
+        m_closeRequested = false;
+        m_window.setVisible(true);
+    }
+    if (!hasData()) {
         std::cerr << "TrajectoryVisualizer:    .  .\n";
         //       
         bool dataNotLoaded = true;
-        while (m_window.isOpen() && dataNotLoaded) {
+        auto handleNoDataEvent = [this](const sf::Event& event) {
+            if (event.type == sf::Event::Closed) closeWindow();
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) closeWindow();
+            m_needsRedraw = true;
+        };
+        while (isWindowOpen() && dataNotLoaded) {
             sf::Event event{};
+            //    -        
+            if (m_onDemandRendering && !m_needsRedraw && m_window.waitEvent(event)) {
+                handleNoDataEvent(event);
+            }
             while (m_window.pollEvent(event)) {
-                if (event.type == sf::Event::Closed) m_window.close();
-                if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape) m_window.close();
+                handleNoDataEvent(event);
+            }
+            if (!isWindowOpen()) break;
+            if (m_needsRedraw || !m_onDemandRendering) {
+                updateInfoText(); //  ,      
+                m_window.clear(sf::Color::Black);
+                m_window.draw(m_infoText); //  - (   )
+                m_window.display();
+                m_needsRedraw = false;
             }
-            updateInfoText(); //  ,      
-            m_window.clear(sf::Color::Black);
-            m_window.draw(m_infoText); //  - (   )
-            m_window.display();
-            if (!m_worldTrajectoryData.empty()) dataNotLoaded = false; //      /
+            if (hasData()) dataNotLoaded = false; //      /
         }
-        if (!m_window.isOpen()) return; //    
+        if (!isWindowOpen()) return; //    
     }
 
-    while (m_window.isOpen()) {
+    m_needsRedraw = true;
+    while (isWindowOpen()) {
         sf::Event event{};
+        //   ,   .      waitEvent,
+        //      ,  GPU,     .
+        if (m_onDemandRendering && !m_needsRedraw && !isAnimating()) {
+            if (m_pager && m_pager->isLoading()) {
+                sf::sleep(PAGER_POLL_INTERVAL); //    ,     
+            }
+            else if (m_window.waitEvent(event)) {
+                handleEvent(event);
+            }
+        }
         while (m_window.pollEvent(event)) {
             handleEvent(event);
         }
+        if (!isWindowOpen()) break;
+
+        if (m_pager && m_pager->consumeUpdates()) {
+            recalculateScreenTrajectory(); //    
+            m_needsRedraw = true;
+        }
+
         updateAnimation();
-        updateInfoText();
-        draw();
+        if (m_needsRedraw || !m_onDemandRendering) {
+            updateInfoText();
+            draw();
+            m_needsRedraw = false;
+        }
     }
 }
 
+void TrajectoryVisualizer::setOnDemandRendering(bool enabled) {
+    m_onDemandRendering = enabled;
+    m_needsRedraw = true;
+}
+
+bool TrajectoryVisualizer::isAnimating() const {
+    return !m_isPaused && !m_showAllPointsImmediately && m_currentPointIndex < m_maxVisiblePoints;
+}
+
+size_t TrajectoryVisualizer::addTrajectory(const WorldTrajectoryData& data) {
+    return addTrajectory(data, paletteColor(m_trajectories.size()));
+}
+
+size_t TrajectoryVisualizer::addTrajectory(const WorldTrajectoryData& data, const sf::Color& color) {
+    m_trajectories.push_back(makeLayer(data, color));
+    recalculateScreenTrajectory();
+    m_needsRedraw = true;
+    return m_trajectories.size() - 1;
+}
+
+TrajectoryVisualizer::TrajectoryLayer TrajectoryVisualizer::makeLayer(const WorldTrajectoryData& data, const sf::Color& color) {
+    TrajectoryLayer layer;
+    layer.color = color;
+    layer.world.x.resize(data.size());
+    layer.world.y.resize(data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+        layer.world.x[i] = static_cast<float>(data[i].first);
+        layer.world.y[i] = static_cast<float>(data[i].second);
+    }
+    layer.index.build(layer.world);
+    return layer;
+}
+
+void TrajectoryVisualizer::clearTrajectories() {
+    m_pager.reset();
+    m_trajectories.clear();
+    clearPicking();
+    recalculateScreenTrajectory();
+    m_needsRedraw = true;
+}
+
+void TrajectoryVisualizer::setTrajectoryVisible(size_t index, bool visible) {
+    if (index >= m_trajectories.size() || m_trajectories[index].visible == visible) return;
+    m_trajectories[index].visible = visible;
+    if (!visible && m_hoverLayer == index) m_hoverPoint = TrajectorySpatialIndex::NO_POINT;
+    recalculateScreenTrajectory(); //  ,       
+    m_needsRedraw = true;
+}
+
+bool TrajectoryVisualizer::isTrajectoryVisible(size_t index) const {
+    return index < m_trajectories.size() && m_trajectories[index].visible;
+}
+
+bool TrajectoryVisualizer::hasData() const {
+    if (m_pager) return true;
+    for (const auto& layer : m_trajectories) {
+        if (!layer.world.x.empty()) return true;
+    }
+    return false;
+}
+
+sf::Color TrajectoryVisualizer::paletteColor(size_t index) {
+    return TRAJECTORY_PALETTE[index % TRAJECTORY_PALETTE_SIZE];
+}
+
 void TrajectoryVisualizer::resetViewAndAnimation() {
     m_scale = DEFAULT_SCALE;
     m_offset = { 0.f, 0.f };
     m_isPaused = false;
-    m_showAllPointsImmediately = false;
+    m_showAllPointsImmediately = m_pager != nullptr; //   out-of-core   
     m_pointsPerFrame = DEFAULT_POINTS_PER_FRAME;
-    m_currentPointIndex = m_worldTrajectoryData.empty() ? 0 : 1;
+    m_currentPointIndex = hasData() ? 1 : 0;
     recalculateScreenTrajectory();
+    m_needsRedraw = true;
 }
 
 sf::Vector2f TrajectoryVisualizer::toScreenCoords(double worldX, double worldY) const {
@@ -111,51 +261,305 @@ sf::Vector2f TrajectoryVisualizer::toWorldCoords(sf::Vector2f screenPos) const {
 }
 
 void TrajectoryVisualizer::recalculateScreenTrajectory() {
-    m_screenTrajectory.clear();
-    if (m_worldTrajectoryData.empty()) return;
+    m_maxVisiblePoints = 0;
+    m_heatmapDirty = true; //        
 
-    m_screenTrajectory.reserve(m_worldTrajectoryData.size());
-    for (const auto& world_point : m_worldTrajectoryData) {
-        m_screenTrajectory.emplace_back(toScreenCoords(world_point.first, world_point.second), sf::Color::White);
+    if (m_pager) refreshOutOfCoreLayer();
+
+    size_t totalVertices = 0;
+    for (const auto& layer : m_trajectories) {
+        if (layer.visible && layer.world.size() > 0) totalVertices += layer.world.size() + 2;
     }
 
+    // resize,   clear + emplace_back:    ,   
+    m_screenTrajectory.resize(totalVertices);
+    const float originX = m_screenCenter.x + m_offset.x;
+    const float originY = m_screenCenter.y + m_offset.y;
+    size_t nextVertex = 0;
+    for (auto& layer : m_trajectories) {
+        layer.vertexOffset = 0;
+        layer.vertexCount = 0;
+        if (!layer.visible || layer.world.size() == 0) continue;
+
+        //      : -""  
+        //   ,     
+        const sf::Color seamColor(layer.color.r, layer.color.g, layer.color.b, 0);
+        layer.vertexOffset = nextVertex + 1;
+        layer.vertexCount = layer.world.size();
+        ScreenProjection::project(layer.world, originX, originY, m_scale, layer.color, &m_screenTrajectory[layer.vertexOffset]);
+        for (size_t seam : layer.seamPoints) {
+            m_screenTrajectory[layer.vertexOffset + seam].color = seamColor;
+        }
+
+        m_screenTrajectory[nextVertex] = sf::Vertex(m_screenTrajectory[layer.vertexOffset].position, seamColor);
+        nextVertex = layer.vertexOffset + layer.vertexCount;
+        m_screenTrajectory[nextVertex] = sf::Vertex(m_screenTrajectory[nextVertex - 1].position, seamColor);
+        ++nextVertex;
+
+        m_maxVisiblePoints = std::max(m_maxVisiblePoints, layer.vertexCount);
+    }
+
+    rebuildSelectionVertices();
+    rebuildEllipseVertices();
+
     if (!m_showAllPointsImmediately) {
-        m_currentPointIndex = std::min(m_currentPointIndex, m_screenTrajectory.size());
-        if (m_currentPointIndex == 0 && !m_screenTrajectory.empty()) {
+        m_currentPointIndex = std::min(m_currentPointIndex, m_maxVisiblePoints);
+        if (m_currentPointIndex == 0 && m_maxVisiblePoints > 0) {
             m_currentPointIndex = 1;
         }
     }
     else {
-        m_currentPointIndex = m_screenTrajectory.size();
+        m_currentPointIndex = m_maxVisiblePoints;
+    }
+}
+
+bool TrajectoryVisualizer::openOutOfCore(const std::string& chunkedFilePath) {
+    std::unique_ptr<TrajectoryPager> pager(new TrajectoryPager());
+    if (!pager->open(chunkedFilePath)) return false;
+    m_trajectories.clear();
+    clearPicking();
+    TrajectoryLayer layer;
+    layer.color = paletteColor(0);
+    m_trajectories.push_back(std::move(layer));
+    m_pager = std::move(pager);
+    resetViewAndAnimation();
+    return true;
+}
+
+void TrajectoryVisualizer::setOutOfCoreTimeWindow(uint64_t firstPoint, uint64_t lastPoint) {
+    if (!m_pager) return;
+    m_pager->setTimeWindow(firstPoint, lastPoint);
+    recalculateScreenTrajectory();
+    m_needsRedraw = true;
+}
+
+void TrajectoryVisualizer::refreshOutOfCoreLayer() {
+    if (m_trajectories.empty()) return;
+    TrajectoryLayer& layer = m_trajectories.front();
+    //      ( Y    )
+    sf::Vector2f topLeft = toWorldCoords({ 0.f, 0.f });
+    sf::Vector2f bottomRight = toWorldCoords(m_screenCenter * 2.f);
+    PointBounds view = { topLeft.x, bottomRight.x, bottomRight.y, topLeft.y };
+    m_pager->assemble(view, OUT_OF_CORE_POINT_BUDGET, layer.world, layer.seamPoints);
+}
+
+void TrajectoryVisualizer::setSampleStates(const std::vector<State>* states, double dt) {
+    m_sampleStates = states;
+    m_sampleTimeStep = dt;
+    if (m_hoverPoint != TrajectorySpatialIndex::NO_POINT) updateHoverText();
+}
+
+size_t TrajectoryVisualizer::drawnPointCount() const {
+    return std::min(m_currentPointIndex, m_maxVisiblePoints);
+}
+
+bool TrajectoryVisualizer::updateHover(sf::Vector2f mousePos) {
+    m_hoverMousePos = mousePos;
+    const sf::Vector2f world = toWorldCoords(mousePos);
+    float radius = HOVER_RADIUS_PX / m_scale;
+    size_t bestLayer = 0;
+    size_t bestPoint = TrajectorySpatialIndex::NO_POINT;
+    for (size_t l = 0; l < m_trajectories.size(); ++l) {
+        const TrajectoryLayer& layer = m_trajectories[l];
+        if (!layer.visible || layer.index.isEmpty()) continue;
+        size_t point = layer.index.nearest(layer.world, world.x, world.y, radius, drawnPointCount());
+        if (point == TrajectorySpatialIndex::NO_POINT) continue;
+        //       
+        radius = std::hypot(layer.world.x[point] - world.x, layer.world.y[point] - world.y);
+        bestLayer = l;
+        bestPoint = point;
+    }
+
+    const bool changed = bestPoint != m_hoverPoint || (bestPoint != TrajectorySpatialIndex::NO_POINT && bestLayer != m_hoverLayer);
+    m_hoverLayer = bestLayer;
+    m_hoverPoint = bestPoint;
+    if (m_hoverPoint != TrajectorySpatialIndex::NO_POINT) updateHoverText(); //    
+    return changed || m_hoverPoint != TrajectorySpatialIndex::NO_POINT;
+}
+
+void TrajectoryVisualizer::updateHoverText() {
+    const TrajectoryLayer& layer = m_trajectories[m_hoverLayer];
+    std::ostringstream oss;
+    oss << std::setprecision(6);
+    oss << "Trajectory " << m_hoverLayer + 1 << ", point " << m_hoverPoint << "\n";
+    //      ,   ,  -   
+    const bool hasState = m_hoverLayer == 0 && m_sampleStates && m_hoverPoint < m_sampleStates->size() &&
+        layer.world.x.size() == m_sampleStates->size();
+    if (hasState) {
+        const State& state = (*m_sampleStates)[m_hoverPoint];
+        if (m_sampleTimeStep > 0.0) oss << "t = " << m_hoverPoint * m_sampleTimeStep << "\n";
+        oss << "x = " << state.x << ", y = " << state.y << "\n";
+        oss << "r = " << std::sqrt(state.x * state.x + state.y * state.y) << "\n";
+        oss << "v = (" << state.vx << ", " << state.vy << "), |v| = " << std::sqrt(state.vx * state.vx + state.vy * state.vy);
+    }
+    else {
+        const double x = layer.world.x[m_hoverPoint];
+        const double y = layer.world.y[m_hoverPoint];
+        oss << "x = " << x << ", y = " << y << "\n";
+        oss << "r = " << std::sqrt(x * x + y * y);
+    }
+    m_hoverText.setString(oss.str());
+
+    //    ,     
+    const sf::FloatRect bounds = m_hoverText.getLocalBounds();
+    sf::Vector2f position = m_hoverMousePos + sf::Vector2f(16.f, 16.f);
+    const sf::Vector2f windowSize = m_screenCenter * 2.f;
+    if (position.x + bounds.width + 8.f > windowSize.x) position.x = m_hoverMousePos.x - bounds.width - 16.f;
+    if (position.y + bounds.height + 8.f > windowSize.y) position.y = m_hoverMousePos.y - bounds.height - 16.f;
+    m_hoverText.setPosition(std::floor(position.x), std::floor(position.y));
+}
+
+void TrajectoryVisualizer::selectInRectangle() {
+    const sf::Vector2f a = toWorldCoords(m_selectionStart);
+    const sf::Vector2f b = toWorldCoords(m_selectionEnd);
+    const PointBounds rect = { std::min(a.x, b.x), std::max(a.x, b.x), std::min(a.y, b.y), std::max(a.y, b.y) };
+
+    m_selectedPoints.assign(m_trajectories.size(), std::vector<uint32_t>());
+    m_selectedCount = 0;
+    for (size_t l = 0; l < m_trajectories.size(); ++l) {
+        const TrajectoryLayer& layer = m_trajectories[l];
+        if (!layer.visible || layer.index.isEmpty()) continue;
+        layer.index.queryRect(layer.world, rect, drawnPointCount(), m_selectedPoints[l]);
+        m_selectedCount += m_selectedPoints[l].size();
+        if (!m_selectedPoints[l].empty()) {
+            std::cout << "TrajectoryVisualizer:  " << l + 1 << " -  " << m_selectedPoints[l].size()
+                << " ,  " << m_selectedPoints[l].front() << ".." << m_selectedPoints[l].back();
+            if (l == 0 && m_sampleStates && m_sampleTimeStep > 0.0) {
+                std::cout << ", t = " << m_selectedPoints[l].front() * m_sampleTimeStep
+                    << ".." << m_selectedPoints[l].back() * m_sampleTimeStep;
+            }
+            std::cout << "\n";
+        }
     }
+    rebuildSelectionVertices();
+}
+
+void TrajectoryVisualizer::rebuildSelectionVertices() {
+    m_selectionVertices.clear();
+    for (size_t l = 0; l < m_selectedPoints.size() && l < m_trajectories.size(); ++l) {
+        const TrajectoryLayer& layer = m_trajectories[l];
+        if (!layer.visible) continue;
+        for (uint32_t index : m_selectedPoints[l]) {
+            if (index < layer.world.size()) {
+                m_selectionVertices.emplace_back(toScreenCoords(layer.world.x[index], layer.world.y[index]), sf::Color::Yellow);
+            }
+        }
+    }
+}
+
+void TrajectoryVisualizer::setUncertaintyEllipses(const std::vector<UncertaintyEllipse>& ellipses) {
+    m_uncertaintyEllipses = ellipses;
+    rebuildEllipseVertices();
+    m_needsRedraw = true;
+}
+
+void TrajectoryVisualizer::rebuildEllipseVertices() {
+    m_ellipseVertices.clear();
+    m_ellipseVertices.reserve(m_uncertaintyEllipses.size() * ELLIPSE_SEGMENTS * 2);
+    const double step = 2.0 * 3.14159265358979323846 / ELLIPSE_SEGMENTS;
+    for (const UncertaintyEllipse& ellipse : m_uncertaintyEllipses) {
+        const double cosAngle = std::cos(ellipse.angle);
+        const double sinAngle = std::sin(ellipse.angle);
+        sf::Vector2f previous;
+        for (unsigned int i = 0; i <= ELLIPSE_SEGMENTS; ++i) {
+            const double u = ellipse.semiMajor * std::cos(i * step);
+            const double v = ellipse.semiMinor * std::sin(i * step);
+            const sf::Vector2f point = toScreenCoords(ellipse.centerX + u * cosAngle - v * sinAngle,
+                ellipse.centerY + u * sinAngle + v * cosAngle);
+            if (i > 0) {
+                m_ellipseVertices.emplace_back(previous, UNCERTAINTY_ELLIPSE_COLOR);
+                m_ellipseVertices.emplace_back(point, UNCERTAINTY_ELLIPSE_COLOR);
+            }
+            previous = point;
+        }
+    }
+}
+
+void TrajectoryVisualizer::clearPicking() {
+    m_hoverPoint = TrajectorySpatialIndex::NO_POINT;
+    m_isSelecting = false;
+    m_selectedPoints.clear();
+    m_selectedCount = 0;
+    m_selectionVertices.clear();
 }
 
 void TrajectoryVisualizer::setupInfoText() {
-    if (!m_font.loadFromFile(FONT_FILENAME)) {
+    //    :        
+    m_font = ResourceCache::instance().font(FONT_FILENAME);
+    if (!m_font) {
         std::cerr << "TrajectoryVisualizer: :     " << FONT_FILENAME << "\n";
+        return; //      
     }
-    m_infoText.setFont(m_font);
+    m_infoText.setFont(*m_font);
     m_infoText.setCharacterSize(INFO_TEXT_CHAR_SIZE);
     m_infoText.setFillColor(sf::Color::Yellow);
     m_infoText.setPosition(10.f, 10.f);
+
+    m_hoverText.setFont(*m_font);
+    m_hoverText.setCharacterSize(INFO_TEXT_CHAR_SIZE);
+    m_hoverText.setFillColor(sf::Color::White);
+
+    //     ,        .
+    //     HUD_DYNAMIC_LINES ,     .
+    m_controlsText.setFont(*m_font);
+    m_controlsText.setCharacterSize(INFO_TEXT_CHAR_SIZE);
+    m_controlsText.setFillColor(sf::Color::Yellow);
+    m_controlsText.setPosition(10.f, 10.f + HUD_DYNAMIC_LINES * m_font->getLineSpacing(INFO_TEXT_CHAR_SIZE));
+    m_controlsText.setString(
+        "Controls:\n"
+        "  Mouse Wheel: Zoom\n"
+        "  Right Mouse Drag: Pan\n"
+        "  Left Mouse Drag: Select points, C: Clear selection\n"
+        "  P: Pause/Resume animation\n"
+        "  F: Toggle full trajectory\n"
+        "  H: Toggle density heatmap\n"
+        "  E: Toggle uncertainty ellipses\n"
+        "  +/-: Change animation speed\n"
+        "  R: Reset view & animation\n"
+        "  1-9: Toggle trajectory, 0: Show all\n"
+        "  Esc: Exit");
+
+    m_hudDirty = true;
+}
+
+TrajectoryVisualizer::HudSnapshot TrajectoryVisualizer::captureHudSnapshot() const {
+    HudSnapshot snapshot;
+    snapshot.scale = m_scale;
+    snapshot.offset = m_offset;
+    snapshot.pointsDrawn = m_currentPointIndex;
+    snapshot.totalPoints = m_maxVisiblePoints;
+    snapshot.trajectoryCount = m_trajectories.size();
+    for (const auto& layer : m_trajectories) {
+        if (layer.visible) ++snapshot.visibleTrajectories;
+    }
+    snapshot.isPaused = m_isPaused;
+    snapshot.pointsPerFrame = m_pointsPerFrame;
+    snapshot.heatmapMode = m_heatmapMode;
+    snapshot.heatmapMaxDensity = m_heatmapMode ? m_heatmapMaxDensity : 0;
+    snapshot.selectedPoints = m_selectedCount;
+    return snapshot;
 }
 
 void TrajectoryVisualizer::updateInfoText() {
+    HudSnapshot snapshot = captureHudSnapshot();
+    if (!m_hudDirty && snapshot == m_hudSnapshot) {
+        return; //    - sf::Text  ,     
+    }
+    m_hudSnapshot = snapshot;
+    m_hudDirty = false;
+
     std::ostringstream oss;
     oss << std::fixed << std::setprecision(2);
-    oss << "Scale: " << m_scale << "\n";
-    oss << "Offset: (" << m_offset.x << ", " << m_offset.y << ")\n";
-    oss << "Points drawn: " << m_currentPointIndex << "/" << m_worldTrajectoryData.size() << "\n";
-    oss << "Animation: " << (m_isPaused ? "Paused" : "Running")
-        << " (" << m_pointsPerFrame << " pts/frame)\n";
-    oss << "Controls:\n";
-    oss << "  Mouse Wheel: Zoom\n";
-    oss << "  Right Mouse Drag: Pan\n";
-    oss << "  P: Pause/Resume animation\n";
-    oss << "  F: Toggle full trajectory\n";
-    oss << "  +/-: Change animation speed\n";
-    oss << "  R: Reset view & animation\n";
-    oss << "  Esc: Exit";
+    oss << "Scale: " << snapshot.scale << "\n";
+    oss << "Offset: (" << snapshot.offset.x << ", " << snapshot.offset.y << ")\n";
+    oss << "Points drawn: " << snapshot.pointsDrawn << "/" << snapshot.totalPoints << "\n";
+    oss << "Trajectories: " << snapshot.visibleTrajectories << "/" << snapshot.trajectoryCount << " visible\n";
+    oss << "Animation: " << (snapshot.isPaused ? "Paused" : "Running")
+        << " (" << snapshot.pointsPerFrame << " pts/frame)\n";
+    oss << "Mode: ";
+    if (snapshot.heatmapMode) oss << "Heatmap (max " << snapshot.heatmapMaxDensity << " pts/pixel)";
+    else oss << "Lines";
+    oss << "\nSelected: " << snapshot.selectedPoints << " points";
     m_infoText.setString(oss.str()); //  sf::Text   sf::String  L""   
     //    ASCII,   oss.str()  .
     //   : m_infoText.setString(sf::String::fromUtf8(oss.str().c_str()));
@@ -164,7 +568,11 @@ void TrajectoryVisualizer::updateInfoText() {
 void TrajectoryVisualizer::handleEvent(const sf::Event& event) {
     switch (event.type) {
     case sf::Event::Closed:
-        m_window.close();
+        closeWindow();
+        break;
+    case sf::Event::GainedFocus:
+    case sf::Event::MouseEntered:
+        m_needsRedraw = true; //     ,    
         break;
     case sf::Event::Resized:
     {
@@ -172,10 +580,12 @@ void TrajectoryVisualizer::handleEvent(const sf::Event& event) {
         m_window.setView(sf::View(visibleArea));
         m_screenCenter = { event.size.width / 2.f, event.size.height / 2.f };
         recalculateScreenTrajectory();
+        m_needsRedraw = true;
     }
     break;
     case sf::Event::KeyPressed:
         handleKeyPress(event.key);
+        m_needsRedraw = true;
         break;
     case sf::Event::MouseWheelScrolled:
         if (event.mouseWheelScroll.wheel == sf::Mouse::VerticalWheel && event.mouseWheelScroll.delta != 0) { //   
@@ -186,18 +596,40 @@ void TrajectoryVisualizer::handleEvent(const sf::Event& event) {
             m_offset.x += (worldPosAfterZoom.x - worldPosBeforeZoom.x) * m_scale;
             m_offset.y += (worldPosAfterZoom.y - worldPosBeforeZoom.y) * m_scale;
             recalculateScreenTrajectory();
+            updateHover(static_cast<sf::Vector2f>(sf::Mouse::getPosition(m_window)));
+            m_needsRedraw = true;
         }
         break;
     case sf::Event::MouseButtonPressed:
         if (event.mouseButton.button == sf::Mouse::Right) {
             m_isDragging = true;
             m_lastMousePos = sf::Mouse::getPosition(m_window);
+            m_hoverPoint = TrajectorySpatialIndex::NO_POINT;
+            m_needsRedraw = true;
+        }
+        else if (event.mouseButton.button == sf::Mouse::Left) {
+            m_isSelecting = true;
+            m_selectionStart = m_selectionEnd = sf::Vector2f(static_cast<float>(event.mouseButton.x), static_cast<float>(event.mouseButton.y));
         }
         break;
     case sf::Event::MouseButtonReleased:
         if (event.mouseButton.button == sf::Mouse::Right) {
             m_isDragging = false;
         }
+        else if (event.mouseButton.button == sf::Mouse::Left && m_isSelecting) {
+            m_isSelecting = false;
+            m_selectionEnd = sf::Vector2f(static_cast<float>(event.mouseButton.x), static_cast<float>(event.mouseButton.y));
+            const sf::Vector2f size = m_selectionEnd - m_selectionStart;
+            if (std::abs(size.x) < SELECTION_MIN_SIZE_PX && std::abs(size.y) < SELECTION_MIN_SIZE_PX) {
+                m_selectedPoints.clear();
+                m_selectedCount = 0;
+                m_selectionVertices.clear();
+            }
+            else {
+                selectInRectangle();
+            }
+            m_needsRedraw = true;
+        }
         break;
     case sf::Event::MouseMoved:
         if (m_isDragging) {
@@ -206,6 +638,20 @@ void TrajectoryVisualizer::handleEvent(const sf::Event& event) {
             m_offset += delta;
             m_lastMousePos = newMousePos;
             recalculateScreenTrajectory();
+            m_needsRedraw = true;
+        }
+        else if (m_isSelecting) {
+            m_selectionEnd = sf::Vector2f(static_cast<float>(event.mouseMove.x), static_cast<float>(event.mouseMove.y));
+            m_needsRedraw = true;
+        }
+        else if (updateHover(sf::Vector2f(static_cast<float>(event.mouseMove.x), static_cast<float>(event.mouseMove.y)))) {
+            m_needsRedraw = true;
+        }
+        break;
+    case sf::Event::MouseLeft:
+        if (m_hoverPoint != TrajectorySpatialIndex::NO_POINT) {
+            m_hoverPoint = TrajectorySpatialIndex::NO_POINT;
+            m_needsRedraw = true;
         }
         break;
     default:
@@ -214,61 +660,187 @@ void TrajectoryVisualizer::handleEvent(const sf::Event& event) {
 }
 
 void TrajectoryVisualizer::handleKeyPress(const sf::Event::KeyEvent& keyEvent) {
-    if (keyEvent.code == sf::Keyboard::Escape) m_window.close();
+    if (keyEvent.code == sf::Keyboard::Escape) closeWindow();
     if (keyEvent.code == sf::Keyboard::P) m_isPaused = !m_isPaused;
     if (keyEvent.code == sf::Keyboard::F) {
         m_showAllPointsImmediately = !m_showAllPointsImmediately;
         if (m_showAllPointsImmediately) {
-            m_currentPointIndex = m_screenTrajectory.size();
+            m_currentPointIndex = m_maxVisiblePoints;
         }
         else {
-            m_currentPointIndex = m_screenTrajectory.empty() ? 0 : 1;
+            m_currentPointIndex = m_maxVisiblePoints == 0 ? 0 : 1;
         }
     }
+    if (keyEvent.code >= sf::Keyboard::Num1 && keyEvent.code <= sf::Keyboard::Num9) {
+        size_t index = static_cast<size_t>(keyEvent.code - sf::Keyboard::Num1);
+        setTrajectoryVisible(index, !isTrajectoryVisible(index));
+    }
+    if (keyEvent.code == sf::Keyboard::Num0) {
+        for (auto& layer : m_trajectories) layer.visible = true;
+        recalculateScreenTrajectory();
+    }
     if (keyEvent.code == sf::Keyboard::Add || keyEvent.code == sf::Keyboard::Equal) { // Equal  +   
         m_pointsPerFrame = std::min(m_pointsPerFrame * ANIMATION_SPEED_MULTIPLIER, MAX_POINTS_PER_FRAME);
     }
     if (keyEvent.code == sf::Keyboard::Subtract || keyEvent.code == sf::Keyboard::Hyphen) { // Hyphen  -   
         m_pointsPerFrame = std::max(m_pointsPerFrame / ANIMATION_SPEED_MULTIPLIER, MIN_POINTS_PER_FRAME);
     }
+    if (keyEvent.code == sf::Keyboard::H) {
+        m_heatmapMode = !m_heatmapMode;
+        m_heatmapDirty = true;
+    }
+    if (keyEvent.code == sf::Keyboard::C) {
+        m_selectedPoints.clear();
+        m_selectedCount = 0;
+        m_selectionVertices.clear();
+    }
+    if (keyEvent.code == sf::Keyboard::E) m_showEllipses = !m_showEllipses;
     if (keyEvent.code == sf::Keyboard::R) resetViewAndAnimation();
 }
 
 void TrajectoryVisualizer::updateAnimation() {
-    if (!m_isPaused && !m_showAllPointsImmediately && m_currentPointIndex < m_screenTrajectory.size()) {
-        m_currentPointIndex = std::min(m_screenTrajectory.size(), m_currentPointIndex + m_pointsPerFrame);
+    if (isAnimating()) {
+        m_currentPointIndex = std::min(m_maxVisiblePoints, m_currentPointIndex + m_pointsPerFrame);
+        m_needsRedraw = true;
+    }
+}
+
+//     ,     ( , 
+//        ),     .
+void TrajectoryVisualizer::updateHeatmap(size_t pointsToDraw) {
+    const sf::Vector2u size = m_window.getSize();
+    if (size.x == 0 || size.y == 0) return;
+    if (size != m_heatmapSize) {
+        m_heatmapSize = size;
+        if (!m_heatmapTexture.create(size.x, size.y)) {
+            std::cerr << "TrajectoryVisualizer: :      \n";
+        }
+        m_heatmapPixels.assign(static_cast<size_t>(size.x) * size.y * 4, 0);
+        m_heatmapDirty = true;
+    }
+    if (m_heatmapDirty || pointsToDraw < m_heatmapBinnedPoints) {
+        m_densityGrid.assign(static_cast<size_t>(size.x) * size.y, 0);
+        m_heatmapBinnedPoints = 0;
+        m_heatmapDirty = false;
+    }
+    else if (pointsToDraw == m_heatmapBinnedPoints) {
+        return; //    -  
+    }
+
+    const float originX = m_screenCenter.x + m_offset.x;
+    const float originY = m_screenCenter.y + m_offset.y;
+    for (const auto& layer : m_trajectories) {
+        if (!layer.visible) continue;
+        ScreenProjection::accumulateDensity(layer.world, m_heatmapBinnedPoints, pointsToDraw,
+            originX, originY, m_scale, size.x, size.y, m_densityGrid);
     }
+    m_heatmapBinnedPoints = pointsToDraw;
+
+    //  :  ,     ,    .
+    //  " ":  ->  -> .   .
+    uint32_t maxDensity = 0;
+    for (uint32_t count : m_densityGrid) maxDensity = std::max(maxDensity, count);
+    m_heatmapMaxDensity = maxDensity;
+    const float invLogMax = maxDensity > 0 ? 1.f / std::log1p(static_cast<float>(maxDensity)) : 0.f;
+    for (size_t i = 0; i < m_densityGrid.size(); ++i) {
+        sf::Uint8* pixel = &m_heatmapPixels[i * 4];
+        if (m_densityGrid[i] == 0) {
+            pixel[3] = 0;
+            continue;
+        }
+        float t = std::log1p(static_cast<float>(m_densityGrid[i])) * invLogMax;
+        t = 0.25f + 0.75f * t; //      
+        pixel[0] = static_cast<sf::Uint8>(255.f * std::min(1.f, 3.f * t));
+        pixel[1] = static_cast<sf::Uint8>(255.f * std::min(1.f, std::max(0.f, 3.f * t - 1.f)));
+        pixel[2] = static_cast<sf::Uint8>(255.f * std::min(1.f, std::max(0.f, 3.f * t - 2.f)));
+        pixel[3] = 255;
+    }
+    m_heatmapTexture.update(m_heatmapPixels.data());
 }
 
 void TrajectoryVisualizer::draw() {
     m_window.clear(sf::Color::Black);
 
+    if (m_heatmapMode && !m_screenTrajectory.empty()) {
+        updateHeatmap(std::min(m_currentPointIndex, m_maxVisiblePoints));
+        m_window.draw(sf::Sprite(m_heatmapTexture)); //   ,    
+    }
+
     sf::CircleShape centerMassShape(CENTER_POINT_RADIUS);
     centerMassShape.setFillColor(sf::Color::Red);
     centerMassShape.setOrigin(CENTER_POINT_RADIUS, CENTER_POINT_RADIUS);
     centerMassShape.setPosition(toScreenCoords(0, 0));
     m_window.draw(centerMassShape);
 
-    if (!m_screenTrajectory.empty()) {
-        size_t pointsToDraw = std::min(m_currentPointIndex, m_screenTrajectory.size());
-        if (pointsToDraw >= 2) {
-            m_window.draw(&m_screenTrajectory[0], pointsToDraw, sf::LineStrip);
+    if (!m_heatmapMode && !m_screenTrajectory.empty()) {
+        size_t pointsToDraw = std::min(m_currentPointIndex, m_maxVisiblePoints);
+        if (pointsToDraw >= m_maxVisiblePoints) {
+            //      -      
+            m_window.draw(m_screenTrajectory.data(), m_screenTrajectory.size(), sf::LineStrip);
         }
-        else if (pointsToDraw == 1) {
-            sf::CircleShape firstPointShape(TRAJECTORY_START_POINT_RADIUS);
-            firstPointShape.setFillColor(sf::Color::White);
-            firstPointShape.setOrigin(TRAJECTORY_START_POINT_RADIUS, TRAJECTORY_START_POINT_RADIUS);
-            firstPointShape.setPosition(m_screenTrajectory[0].position);
-            m_window.draw(firstPointShape);
+        else {
+            // :      pointsToDraw    
+            for (const auto& layer : m_trajectories) {
+                size_t layerPoints = std::min(pointsToDraw, layer.vertexCount);
+                if (layerPoints >= 2) {
+                    m_window.draw(&m_screenTrajectory[layer.vertexOffset], layerPoints, sf::LineStrip);
+                }
+            }
         }
+
+        //     LineStrip   -   
+        for (const auto& layer : m_trajectories) {
+            if (pointsToDraw == 1 ? layer.vertexCount >= 1 : layer.vertexCount == 1) {
+                sf::CircleShape firstPointShape(TRAJECTORY_START_POINT_RADIUS);
+                firstPointShape.setFillColor(layer.color);
+                firstPointShape.setOrigin(TRAJECTORY_START_POINT_RADIUS, TRAJECTORY_START_POINT_RADIUS);
+                firstPointShape.setPosition(m_screenTrajectory[layer.vertexOffset].position);
+                m_window.draw(firstPointShape);
+            }
+        }
+    }
+
+    if (m_showEllipses && !m_ellipseVertices.empty()) {
+        m_window.draw(m_ellipseVertices.data(), m_ellipseVertices.size(), sf::Lines);
+    }
+    if (!m_selectionVertices.empty()) {
+        m_window.draw(m_selectionVertices.data(), m_selectionVertices.size(), sf::Points);
+    }
+    if (m_isSelecting) {
+        sf::RectangleShape selectionShape(m_selectionEnd - m_selectionStart);
+        selectionShape.setPosition(m_selectionStart);
+        selectionShape.setFillColor(sf::Color(255, 255, 0, 40));
+        selectionShape.setOutlineColor(sf::Color::Yellow);
+        selectionShape.setOutlineThickness(1.f);
+        m_window.draw(selectionShape);
+    }
+    if (m_hoverPoint != TrajectorySpatialIndex::NO_POINT) {
+        const TrajectoryLayer& layer = m_trajectories[m_hoverLayer];
+        sf::CircleShape marker(HOVER_MARKER_RADIUS);
+        marker.setFillColor(sf::Color::Transparent);
+        marker.setOutlineColor(sf::Color::Yellow);
+        marker.setOutlineThickness(1.5f);
+        marker.setOrigin(HOVER_MARKER_RADIUS, HOVER_MARKER_RADIUS);
+        marker.setPosition(toScreenCoords(layer.world.x[m_hoverPoint], layer.world.y[m_hoverPoint]));
+        m_window.draw(marker);
+
+        const sf::FloatRect textBounds = m_hoverText.getGlobalBounds();
+        sf::RectangleShape background(sf::Vector2f(textBounds.width + 8.f, textBounds.height + 8.f));
+        background.setPosition(textBounds.left - 4.f, textBounds.top - 4.f);
+        background.setFillColor(sf::Color(0, 0, 0, 200));
+        background.setOutlineColor(layer.color);
+        background.setOutlineThickness(1.f);
+        m_window.draw(background);
+        m_window.draw(m_hoverText);
     }
 
     m_window.draw(m_infoText);
+    m_window.draw(m_controlsText);
     m_window.display();
 }
 
 bool TrajectoryVisualizer::saveTrajectoryToFile(const std::string& filename) const {
-    if (m_worldTrajectoryData.empty()) {
+    if (m_trajectories.empty() || m_trajectories.front().world.x.empty()) {
         std::cerr << "TrajectoryVisualizer:        '" << filename << "'.\n";
         return false; //  false,   
     }
@@ -283,10 +855,14 @@ bool TrajectoryVisualizer::saveTrajectoryToFile(const std::string& filename) con
     //       
     outputFile << std::fixed << std::setprecision(10); // 10   
 
-    for (const auto& point : m_worldTrajectoryData) {
-        // m_worldTrajectoryData  std::vector<std::pair<double, double>>
-        // point.first  x, point.second  y
-        outputFile << point.first << " " << point.second << "\n";
+    //   -   ,      ,
+    //  -    float
+    const WorldPointsSoA& world = m_trajectories.front().world;
+    const size_t pointCount = world.x.size();
+    const bool hasStates = m_sampleStates && m_sampleStates->size() == pointCount;
+    for (size_t i = 0; i < pointCount; ++i) {
+        if (hasStates) outputFile << (*m_sampleStates)[i].x << " " << (*m_sampleStates)[i].y << "\n";
+        else outputFile << world.x[i] << " " << world.y[i] << "\n";
     }
         
     outputFile.close(); //  
@@ -296,7 +872,7 @@ bool TrajectoryVisualizer::saveTrajectoryToFile(const std::string& filename) con
         return false;
     }
 
-    std::cout << "TrajectoryVisualizer:  (" << m_worldTrajectoryData.size()
+    std::cout << "TrajectoryVisualizer:  (" << pointCount
         << " )     '" << filename << "'.\n";
     return true;
 }
\ No newline at end of file
@@ -12,6 +12,13 @@
 #include <iomanip>  //  std::fixed, std::setprecision
 #include <algorithm> //  std::min, std::max (,   )
 
+#include "ScreenProjection.h" //     
+#include "TrajectoryPager.h"  //  ,    
+#include "TrajectorySpatialIndex.h" //       
+#include "ResourceCache.h"  //    
+#include "UncertaintyPropagation.h" //   
+#include <memory>
+
 //     ,    Calculations.h
 //     "types.h",     .
 using WorldTrajectoryPoint = std::pair<double, double>;
@@ -20,14 +27,45 @@ using WorldTrajectoryData = std::vector<WorldTrajectoryPoint>;
 
 class TrajectoryVisualizer {
 public:
+    //     ResourceCache       ,
+    //         OpenGL- 
     TrajectoryVisualizer(unsigned int width, unsigned int height, const std::string& windowTitle = "Trajectory Visualizer");
+    ~TrajectoryVisualizer();
 
-    void setData(const WorldTrajectoryData& data);
+    void setData(const WorldTrajectoryData& data); //     ()
     bool loadDataFromFile(const std::string& filename);
     void run();
     void resetViewAndAnimation();
 
-    bool saveTrajectoryToFile(const std::string& filename) const; 
+    //     (  ):   
+    //   ,      .
+    //   -    ,  .
+    void setOnDemandRendering(bool enabled);
+
+    //      (,     ).
+    //            .
+    size_t addTrajectory(const WorldTrajectoryData& data);                       //   
+    size_t addTrajectory(const WorldTrajectoryData& data, const sf::Color& color);
+    void clearTrajectories();
+    void setTrajectoryVisible(size_t index, bool visible);
+    bool isTrajectoryVisible(size_t index) const;
+    size_t getTrajectoryCount() const { return m_trajectories.size(); }
+
+    bool saveTrajectoryToFile(const std::string& filename) const; //   () 
+
+    // Out-of-core :   ChunkedTrajectoryFile  , 
+    //        OUT_OF_CORE_POINT_BUDGET   .
+    //   . setData / clearTrajectories   .
+    bool openOutOfCore(const std::string& chunkedFilePath);
+    void setOutOfCoreTimeWindow(uint64_t firstPoint, uint64_t lastPoint);
+
+    //    ,      t, r  v.
+    //      ,   .   -   .
+    void setSampleStates(const std::vector<State>* states, double dt);
+
+    //       (UncertaintyPropagation::positionEllipse),  .
+    //   ,  E    .    .
+    void setUncertaintyEllipses(const std::vector<UncertaintyEllipse>& ellipses);
 
 private:
     // ---   ---
@@ -39,13 +77,39 @@ private:
     static constexpr unsigned int ANIMATION_SPEED_MULTIPLIER = 2;
     const std::string FONT_FILENAME = "arial.ttf";
     static constexpr unsigned int INFO_TEXT_CHAR_SIZE = 16;
+    static constexpr unsigned int HUD_DYNAMIC_LINES = 7; //      HUD
     static constexpr float CENTER_POINT_RADIUS = 5.0f;
     static constexpr float TRAJECTORY_START_POINT_RADIUS = 2.0f;
     static constexpr float ZOOM_FACTOR_STEP = 1.3f;
+    static constexpr size_t OUT_OF_CORE_POINT_BUDGET = 2000000;
+    static constexpr float HOVER_RADIUS_PX = 8.0f;       //       
+    static constexpr float HOVER_MARKER_RADIUS = 4.0f;
+    static constexpr float SELECTION_MIN_SIZE_PX = 3.0f; //    -  ,  
+    static constexpr unsigned int ELLIPSE_SEGMENTS = 64; //     
+    //     ,    (   waitEvent)
+    const sf::Time PAGER_POLL_INTERVAL = sf::milliseconds(15);
+
+    //    .       m_screenTrajectory
+    //   [vertexOffset, vertexOffset + vertexCount).
+    struct TrajectoryLayer {
+        WorldPointsSoA world;   //   (float):     ;  -  m_sampleStates
+        sf::Color color;
+        bool visible = true;
+        std::vector<size_t> seamPoints; //  - ( ), out-of-core 
+        TrajectorySpatialIndex index;   //   world    ;  out-of-core  
+        size_t vertexOffset = 0;
+        size_t vertexCount = 0; // 0,   
+    };
 
-    sf::RenderWindow m_window;
-    WorldTrajectoryData m_worldTrajectoryData;
+    std::unique_ptr<sf::RenderWindow> m_windowHandle; //    
+    sf::RenderWindow& m_window;
+    bool m_closeRequested; //   : run() ,    
+    std::vector<TrajectoryLayer> m_trajectories;
+    std::unique_ptr<TrajectoryPager> m_pager; //  null  out-of-core ,  -  m_trajectories[0]
+    //      .    
+    //  ,       sf::LineStrip.
     std::vector<sf::Vertex> m_screenTrajectory;
+    size_t m_maxVisiblePoints; //     
 
     float m_scale;
     sf::Vector2f m_offset;
@@ -56,21 +120,97 @@ private:
     bool m_isPaused;
     bool m_showAllPointsImmediately;
 
-    sf::Font m_font;
-    sf::Text m_infoText;
+    //   :          ,
+    //      .      ,   .
+    bool m_heatmapMode;
+    bool m_heatmapDirty;              //      -    
+    size_t m_heatmapBinnedPoints;     //        
+    uint32_t m_heatmapMaxDensity;
+    sf::Vector2u m_heatmapSize;
+    std::vector<uint32_t> m_densityGrid;
+    std::vector<sf::Uint8> m_heatmapPixels; // RGBA
+    sf::Texture m_heatmapTexture;
+
+    //        (  )
+    const std::vector<State>* m_sampleStates;
+    double m_sampleTimeStep;
+    size_t m_hoverLayer;
+    size_t m_hoverPoint; // TrajectorySpatialIndex::NO_POINT,     
+    sf::Vector2f m_hoverMousePos;
+    sf::Text m_hoverText;
+    bool m_isSelecting;
+    sf::Vector2f m_selectionStart, m_selectionEnd;       //    
+    std::vector<std::vector<uint32_t>> m_selectedPoints; //     
+    size_t m_selectedCount;
+    std::vector<sf::Vertex> m_selectionVertices;         //    
+
+    //   :         
+    std::vector<UncertaintyEllipse> m_uncertaintyEllipses;
+    std::vector<sf::Vertex> m_ellipseVertices; // sf::Lines, ELLIPSE_SEGMENTS   
+    bool m_showEllipses;
+
+    std::shared_ptr<const sf::Font> m_font; //  ResourceCache; null,    
+    sf::Text m_infoText;      //   HUD (, , , )
+    sf::Text m_controlsText;  //    ,   
+
+    // ,       m_infoText.
+    //          .
+    struct HudSnapshot {
+        float scale = 0.f;
+        sf::Vector2f offset;
+        size_t pointsDrawn = 0;
+        size_t totalPoints = 0;
+        size_t visibleTrajectories = 0;
+        size_t trajectoryCount = 0;
+        bool isPaused = false;
+        unsigned int pointsPerFrame = 0;
+        bool heatmapMode = false;
+        uint32_t heatmapMaxDensity = 0;
+        size_t selectedPoints = 0;
+
+        bool operator==(const HudSnapshot& other) const {
+            return scale == other.scale && offset == other.offset &&
+                pointsDrawn == other.pointsDrawn && totalPoints == other.totalPoints &&
+                visibleTrajectories == other.visibleTrajectories && trajectoryCount == other.trajectoryCount &&
+                isPaused == other.isPaused && pointsPerFrame == other.pointsPerFrame &&
+                heatmapMode == other.heatmapMode && heatmapMaxDensity == other.heatmapMaxDensity &&
+                selectedPoints == other.selectedPoints;
+        }
+    };
+    HudSnapshot m_hudSnapshot;
+    bool m_hudDirty;
 
     bool m_isDragging;
     sf::Vector2i m_lastMousePos;
 
+    bool m_onDemandRendering;
+    bool m_needsRedraw; //      
+
     //  
     sf::Vector2f toScreenCoords(double worldX, double worldY) const;
     sf::Vector2f toWorldCoords(sf::Vector2f screenPos) const;
     void recalculateScreenTrajectory();
+    void refreshOutOfCoreLayer(); //    m_pager   
+    bool hasData() const;
+    bool isWindowOpen() const { return m_window.isOpen() && !m_closeRequested; }
+    void closeWindow();
+    static sf::Color paletteColor(size_t index);
+    static TrajectoryLayer makeLayer(const WorldTrajectoryData& data, const sf::Color& color);
     void setupInfoText();
     void updateInfoText();
+    HudSnapshot captureHudSnapshot() const;
     void handleEvent(const sf::Event& event);
     void handleKeyPress(const sf::Event::KeyEvent& keyEvent);
     void updateAnimation();
+    bool isAnimating() const;
+    void updateHeatmap(size_t pointsToDraw);
+    size_t drawnPointCount() const; //        
+    bool updateHover(sf::Vector2f mousePos); // true,     
+    void updateHoverText();
+    void selectInRectangle();
+    void rebuildSelectionVertices();
+    void rebuildEllipseVertices();
+    void clearPicking();
     void draw();
 };
 
@@ -0,0 +1,269 @@
+#include "UncertaintyPropagation.h"
+#include "IntegratorCore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+constexpr int UncertaintyPropagation::STATE_SIZE;
+constexpr int UncertaintyPropagation::SIGMA_POINTS;
+
+namespace {
+
+const uint64_t MONTE_CARLO_SEED = 20240601; // ,   
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void toArray(const State& s, double v[4]) {
+    v[0] = s.x;
+    v[1] = s.y;
+    v[2] = s.vx;
+    v[3] = s.vy;
+}
+
+//      
+void weightedMoments(const std::vector<State>& batch, const std::vector<double>& meanWeights,
+    const std::vector<double>& covarianceWeights, UncertaintyEpoch& epoch) {
+    double mean[4] = { 0.0, 0.0, 0.0, 0.0 };
+    for (size_t i = 0; i < batch.size(); ++i) {
+        double v[4];
+        toArray(batch[i], v);
+        for (int a = 0; a < 4; ++a) mean[a] += meanWeights[i] * v[a];
+    }
+    for (int a = 0; a < 4; ++a) {
+        for (int b = 0; b < 4; ++b) epoch.covariance[a][b] = 0.0;
+    }
+    for (size_t i = 0; i < batch.size(); ++i) {
+        double v[4];
+        toArray(batch[i], v);
+        double d[4];
+        for (int a = 0; a < 4; ++a) d[a] = v[a] - mean[a];
+        for (int a = 0; a < 4; ++a) {
+            for (int b = 0; b < 4; ++b) epoch.covariance[a][b] += covarianceWeights[i] * d[a] * d[b];
+        }
+    }
+    epoch.mean = { mean[0], mean[1], mean[2], mean[3] };
+}
+
+double positionSpread(const UncertaintyEpoch& epoch) {
+    return std::sqrt(std::max(0.0, epoch.covariance[0][0] + epoch.covariance[1][1]));
+}
+
+}
+
+void UncertaintyParameters::setIndependent(double sigmaX, double sigmaY, double sigmaVx, double sigmaVy) {
+    const double sigma[4] = { sigmaX, sigmaY, sigmaVx, sigmaVy };
+    for (int a = 0; a < 4; ++a) {
+        for (int b = 0; b < 4; ++b) COVARIANCE[a][b] = a == b ? sigma[a] * sigma[a] : 0.0;
+    }
+}
+
+UncertaintyPropagation::UncertaintyPropagation()
+    : m_cancel(nullptr) {
+}
+
+bool UncertaintyPropagation::choleskyFactor(const double covariance[4][4], double factor[4][4]) {
+    double scale = 0.0;
+    for (int a = 0; a < 4; ++a) scale = std::max(scale, std::abs(covariance[a][a]));
+    const double tolerance = 1e-12 * scale;
+
+    for (int a = 0; a < 4; ++a) {
+        for (int b = 0; b < 4; ++b) {
+            if (std::abs(covariance[a][b] - covariance[b][a]) > tolerance) return false;
+            factor[a][b] = 0.0;
+        }
+    }
+    //    :  (  )     
+    for (int j = 0; j < 4; ++j) {
+        double pivot = covariance[j][j];
+        for (int k = 0; k < j; ++k) pivot -= factor[j][k] * factor[j][k];
+        if (pivot < -tolerance) return false;
+        if (pivot <= tolerance) continue;
+        factor[j][j] = std::sqrt(pivot);
+        for (int i = j + 1; i < 4; ++i) {
+            double sum = covariance[i][j];
+            for (int k = 0; k < j; ++k) sum -= factor[i][k] * factor[j][k];
+            factor[i][j] = sum / factor[j][j];
+        }
+    }
+    return true;
+}
+
+std::vector<int> UncertaintyPropagation::epochSteps(int totalSteps, int epochCount) {
+    std::vector<int> steps;
+    const int count = std::max(1, epochCount);
+    steps.push_back(0); //  
+    for (int k = 1; k <= count; ++k) {
+        int step = static_cast<int>(static_cast<long long>(totalSteps) * k / count);
+        if (step > steps.back()) steps.push_back(step);
+    }
+    return steps;
+}
+
+template <typename EpochFn>
+bool UncertaintyPropagation::integrateBatch(const SimulationParameters& params, std::vector<State>& batch,
+    const std::vector<int>& epochs, int& completedSteps, EpochFn onEpoch) const {
+    const IntegratorCore<double> core(params);
+    size_t nextEpoch = 0;
+    int step = 0;
+    bool collided = false;
+    while (nextEpoch < epochs.size()) {
+        if (step == epochs[nextEpoch]) {
+            onEpoch(step, batch);
+            ++nextEpoch;
+            continue;
+        }
+        if (isCancelled()) break;
+        for (State& s : batch) {
+            s = core.rungeKuttaStep(s, params.DT);
+            collided = collided || core.isInsideCentralBody(s);
+        }
+        ++step;
+        if (collided) {
+            onEpoch(step, batch); //     -  
+            break;
+        }
+    }
+    completedSteps = step;
+    return collided;
+}
+
+UncertaintyReport UncertaintyPropagation::runSimulation(const SimulationParameters& params,
+    const UncertaintyParameters& uncertaintyParams) {
+    UncertaintyReport report;
+    const auto startTime = std::chrono::steady_clock::now();
+    if (params.PRECISION != Precision::Double || params.SUNDMAN_STEP > 0.0) {
+        std::cout << "UncertaintyPropagation:       4,  "
+            << "    \n";
+    }
+
+    double factor[4][4];
+    if (!choleskyFactor(uncertaintyParams.COVARIANCE, factor)) {
+        std::cerr << "UncertaintyPropagation:        \n";
+        return report;
+    }
+    const double n = STATE_SIZE;
+    const double alphaSquared = uncertaintyParams.ALPHA * uncertaintyParams.ALPHA;
+    const double lambda = alphaSquared * (n + uncertaintyParams.KAPPA) - n;
+    if (!(n + lambda > 0.0)) {
+        std::cerr << "UncertaintyPropagation: ALPHA^2 (4 + KAPPA)    0\n";
+        return report;
+    }
+    report.valid = true;
+
+    // -:   +-sqrt(n + lambda) *   
+    const double spread = std::sqrt(n + lambda);
+    const State mean = { params.initialState.x, params.initialState.y, params.initialState.vx, params.initialState.vy };
+    std::vector<State> batch(SIGMA_POINTS, mean);
+    for (int j = 0; j < STATE_SIZE; ++j) {
+        double column[4];
+        for (int a = 0; a < 4; ++a) column[a] = spread * factor[a][j];
+        State& plus = batch[1 + j];
+        State& minus = batch[1 + STATE_SIZE + j];
+        plus = { mean.x + column[0], mean.y + column[1], mean.vx + column[2], mean.vy + column[3] };
+        minus = { mean.x - column[0], mean.y - column[1], mean.vx - column[2], mean.vy - column[3] };
+    }
+    std::vector<double> meanWeights(SIGMA_POINTS, 1.0 / (2.0 * (n + lambda)));
+    std::vector<double> covarianceWeights(meanWeights);
+    meanWeights[0] = lambda / (n + lambda);
+    covarianceWeights[0] = meanWeights[0] + (1.0 - alphaSquared + uncertaintyParams.BETA);
+
+    const std::vector<int> epochs = epochSteps(std::max(0, params.STEPS), uncertaintyParams.EPOCH_COUNT);
+    report.epochs.reserve(epochs.size() + 1);
+    report.collided = integrateBatch(params, batch, epochs, report.completedSteps,
+        [&](int step, const std::vector<State>& points) {
+            UncertaintyEpoch epoch;
+            epoch.step = step;
+            epoch.time = step * params.DT;
+            weightedMoments(points, meanWeights, covarianceWeights, epoch);
+            report.epochs.push_back(epoch);
+        });
+    report.unscentedSeconds = secondsSince(startTime);
+    if (isCancelled()) {
+        report.cancelled = true;
+        return report;
+    }
+
+    if (uncertaintyParams.MONTE_CARLO_SAMPLES > 0) {
+        compareWithMonteCarlo(params, uncertaintyParams, factor, epochs, report);
+        if (isCancelled()) {
+            report.cancelled = true;
+            return report;
+        }
+    }
+
+    const UncertaintyEpoch& last = report.epochs.back();
+    std::cout << "UncertaintyPropagation: " << SIGMA_POINTS << " -,  " << report.epochs.size()
+        << ",  " << report.completedSteps << (report.collided ? " ()" : "")
+        << ",  " << report.unscentedSeconds << " ,     " << positionSpread(last);
+    if (uncertaintyParams.MONTE_CARLO_SAMPLES > 0) {
+        std::cout << "; - (" << uncertaintyParams.MONTE_CARLO_SAMPLES << "): " << report.monteCarloSeconds
+            << " ,   " << report.maxMeanDifference
+            << ",  " << report.maxSpreadDifference * 100.0 << "%";
+    }
+    std::cout << "\n";
+    return report;
+}
+
+void UncertaintyPropagation::compareWithMonteCarlo(const SimulationParameters& params,
+    const UncertaintyParameters& uncertaintyParams, const double factor[4][4], const std::vector<int>& epochs,
+    UncertaintyReport& report) const {
+    const auto startTime = std::chrono::steady_clock::now();
+    const size_t samples = static_cast<size_t>(uncertaintyParams.MONTE_CARLO_SAMPLES);
+    const State mean = { params.initialState.x, params.initialState.y, params.initialState.vx, params.initialState.vy };
+
+    std::mt19937_64 generator(MONTE_CARLO_SEED);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    std::vector<State> batch(samples);
+    for (State& s : batch) {
+        double z[4];
+        for (int a = 0; a < 4; ++a) z[a] = normal(generator);
+        double d[4] = { 0.0, 0.0, 0.0, 0.0 };
+        for (int a = 0; a < 4; ++a) {
+            for (int b = 0; b <= a; ++b) d[a] += factor[a][b] * z[b];
+        }
+        s = { mean.x + d[0], mean.y + d[1], mean.vx + d[2], mean.vy + d[3] };
+    }
+
+    //     ()
+    const std::vector<double> meanWeights(samples, 1.0 / samples);
+    const std::vector<double> covarianceWeights(samples, samples > 1 ? 1.0 / (samples - 1) : 0.0);
+    size_t epochIndex = 0;
+    int sampledSteps = 0;
+    integrateBatch(params, batch, epochs, sampledSteps, [&](int step, const std::vector<State>& points) {
+        if (epochIndex >= report.epochs.size() || report.epochs[epochIndex].step != step) return;
+        const UncertaintyEpoch& unscented = report.epochs[epochIndex++];
+        UncertaintyEpoch sampled;
+        weightedMoments(points, meanWeights, covarianceWeights, sampled);
+
+        const double dx = unscented.mean.x - sampled.mean.x;
+        const double dy = unscented.mean.y - sampled.mean.y;
+        report.maxMeanDifference = std::max(report.maxMeanDifference, std::sqrt(dx * dx + dy * dy));
+        const double sampledSpread = positionSpread(sampled);
+        if (sampledSpread > 0.0) {
+            report.maxSpreadDifference = std::max(report.maxSpreadDifference,
+                std::abs(positionSpread(unscented) - sampledSpread) / sampledSpread);
+        }
+    });
+    report.monteCarloSeconds = secondsSince(startTime);
+}
+
+UncertaintyEllipse UncertaintyPropagation::positionEllipse(const UncertaintyEpoch& epoch, double sigmaScale) {
+    const double a = epoch.covariance[0][0];
+    const double b = 0.5 * (epoch.covariance[0][1] + epoch.covariance[1][0]);
+    const double c = epoch.covariance[1][1];
+    const double center = 0.5 * (a + c);
+    const double radius = std::sqrt(0.25 * (a - c) * (a - c) + b * b);
+
+    UncertaintyEllipse ellipse;
+    ellipse.centerX = epoch.mean.x;
+    ellipse.centerY = epoch.mean.y;
+    ellipse.semiMajor = sigmaScale * std::sqrt(std::max(0.0, center + radius));
+    ellipse.semiMinor = sigmaScale * std::sqrt(std::max(0.0, center - radius));
+    ellipse.angle = 0.5 * std::atan2(2.0 * b, a - c);
+    return ellipse;
+}
@@ -0,0 +1,99 @@
+#ifndef UNCERTAINTYPROPAGATION_H
+#define UNCERTAINTYPROPAGATION_H
+
+#include <atomic>
+#include <vector>
+
+#include "Calculations.h"
+
+//     
+struct UncertaintyParameters {
+    //     (x, y, vx, vy)  params.initialState.
+    //      ;   .
+    double COVARIANCE[4][4] = {};
+    //  - ( ): lambda = ALPHA^2 (4 + KAPPA) - 4.
+    //   lambda = 0:   +-2 ,      .
+    double ALPHA = 1.0;
+    double BETA = 2.0;    // 2 -    
+    double KAPPA = 0.0;
+    int EPOCH_COUNT = 10; // ,       (  STEPS)
+    int MONTE_CARLO_SAMPLES = 0; // >0 -       -  
+
+    //   :     
+    void setIndependent(double sigmaX, double sigmaY, double sigmaVx, double sigmaVy);
+};
+
+//       step * DT
+struct UncertaintyEpoch {
+    int step = 0;
+    double time = 0.0;
+    State mean = { 0.0, 0.0, 0.0, 0.0 };
+    double covariance[4][4] = {};
+};
+
+//   :    , angle -      x ()
+struct UncertaintyEllipse {
+    double centerX = 0.0;
+    double centerY = 0.0;
+    double semiMajor = 0.0;
+    double semiMinor = 0.0;
+    double angle = 0.0;
+};
+
+//  
+struct UncertaintyReport {
+    bool valid = false;      // false -    (    PSD)
+    bool collided = false;   //   -    :    
+    bool cancelled = false;  //    ,  
+    int completedSteps = 0;
+    std::vector<UncertaintyEpoch> epochs;
+    double unscentedSeconds = 0.0;
+    double monteCarloSeconds = 0.0;   // 0,  MONTE_CARLO_SAMPLES = 0
+    double maxMeanDifference = 0.0;   //      UT  -
+    double maxSpreadDifference = 0.0; //    sqrt(Cxx + Cyy)
+};
+
+//     - (unscented transform).
+//    2n+1 = 9 ,   ,    
+// (   ,  ),       
+//   .      -;  
+//   ,      StateSensitivity.
+//   4  DT   ,   Calculations  Precision::Double
+// (     ); Sundman     .
+class UncertaintyPropagation {
+public:
+    static constexpr int STATE_SIZE = 4;
+    static constexpr int SIGMA_POINTS = 2 * STATE_SIZE + 1;
+
+    UncertaintyPropagation();
+
+    UncertaintyReport runSimulation(const SimulationParameters& params, const UncertaintyParameters& uncertaintyParams);
+    //     ; true  runSimulation (report.cancelled). nullptr -  
+    void setCancelFlag(const std::atomic<bool>* cancel) { m_cancel = cancel; }
+
+    //    sigmaScale   (   Cxx, Cxy, Cyy)
+    static UncertaintyEllipse positionEllipse(const UncertaintyEpoch& epoch, double sigmaScale);
+
+private:
+    //       
+    static bool choleskyFactor(const double covariance[4][4], double factor[4][4]);
+
+    static std::vector<int> epochSteps(int totalSteps, int epochCount);
+
+    bool isCancelled() const { return m_cancel && m_cancel->load(std::memory_order_relaxed); }
+
+    //       ;     onEpoch(step, batch).
+    //  -     ,     
+    // (   )   true.    .
+    template <typename EpochFn>
+    bool integrateBatch(const SimulationParameters& params, std::vector<State>& batch,
+        const std::vector<int>& epochs, int& completedSteps, EpochFn onEpoch) const;
+
+    //      MONTE_CARLO_SAMPLES :     UT  report
+    void compareWithMonteCarlo(const SimulationParameters& params, const UncertaintyParameters& uncertaintyParams,
+        const double factor[4][4], const std::vector<int>& epochs, UncertaintyReport& report) const;
+
+    const std::atomic<bool>* m_cancel;
+};
+
+#endif // UNCERTAINTYPROPAGATION_H
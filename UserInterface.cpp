@@ -1,5 +1,6 @@
 #include "UserInterface.h"
 #include "TrajectoryVisualizer.h"
+#include "KeplerPropagator.h"
 
 #include <iostream> //  
 #include <algorithm> //  std::min_element, std::max_element
@@ -28,18 +29,34 @@ std::pair<tgui::Label::Ptr, tgui::EditBox::Ptr> createInputRowControls(const sf:
 UserInterface::UserInterface()
     : m_window({ 1200, 800 }, L"   "),
     m_gui(m_window),
-    m_trajectoryAvailable(false) {
+    m_calculatedTimeStep(0.0),
+    m_uncertaintyEnabled(false),
+    m_uncertaintyRequested(false),
+    m_stopUncertaintyWorker(false),
+    m_uncertaintyCancel(false),
+    m_trajectoryAvailable(false),
+    m_onDemandRendering(true),
+    m_needsRedraw(true),
+    m_canvasDirty(true) {
 
     m_gui.setFont("arial.ttf");
 
-    //    SFML (  Canvas)
-    if (!m_sfmlFont.loadFromFile("arial.ttf")) {
-        std::cerr << "SFML: Error - Failed to load font 'arial.ttf' for SFML rendering!\n";
-    }
+    //    :        
+    m_simulationSession.setCheckpointPath(SIMULATION_CHECKPOINT_PATH, SIMULATION_CHECKPOINT_INTERVAL_STEPS);
 
     initializeGui();
 }
 
+UserInterface::~UserInterface() {
+    {
+        std::lock_guard<std::mutex> lock(m_uncertaintyMutex);
+        m_stopUncertaintyWorker = true;
+        m_uncertaintyCancel = true;
+    }
+    m_uncertaintyChanged.notify_all();
+    if (m_uncertaintyWorker.joinable()) m_uncertaintyWorker.join();
+}
+
 void UserInterface::initializeGui() {
     std::cout << "DEBUG: Initializing GUI..." << std::endl;
     loadWidgets();
@@ -104,6 +121,28 @@ void UserInterface::loadLeftPanelWidgets() {
     addInputRowToGrid(L"k ():", m_edit_k);
     addInputRowToGrid(L"F ():", m_edit_F);
 
+    //  
+    auto precisionLabel = tgui::Label::create(L":");
+    m_precisionComboBox = tgui::ComboBox::create();
+    if (precisionLabel && m_precisionComboBox) {
+        precisionLabel->getRenderer()->setTextColor(tgui::Color::Black);
+        precisionLabel->setVerticalAlignment(tgui::Label::VerticalAlignment::Center);
+        m_precisionComboBox->setSize({ INPUT_FIELD_WIDTH, INPUT_ROW_HEIGHT });
+        m_precisionComboBox->addItem(L"float ()");
+        m_precisionComboBox->addItem(L"double");
+        m_precisionComboBox->addItem(L"long double");
+        m_precisionComboBox->addItem(L"double + ");
+        m_precisionComboBox->setSelectedItemByIndex(static_cast<std::size_t>(Precision::Double));
+        m_inputControlsGrid->addWidget(precisionLabel, currentRow, 0);
+        m_inputControlsGrid->addWidget(m_precisionComboBox, currentRow, 1);
+        m_inputControlsGrid->setWidgetPadding(currentRow, 0, { 5, 5, 5, 0 });
+        m_inputControlsGrid->setWidgetPadding(currentRow, 1, { 5, 0, 5, 5 });
+        currentRow++;
+    }
+    else {
+        std::cerr << "Error: Failed to create precision selector" << std::endl;
+    }
+
     // 3.  " !"
     m_calculateButton = tgui::Button::create(L" !");
     if (!m_calculateButton) { std::cerr << "Error: Failed to create m_calculateButton" << std::endl; return; }
@@ -121,6 +160,24 @@ void UserInterface::loadLeftPanelWidgets() {
     //    
     m_showVisualizerButton->setPosition({ PANEL_PADDING, tgui::bindBottom(m_calculateButton) + WIDGET_SPACING / 2.0f });
     m_leftPanel->add(m_showVisualizerButton);
+
+    // 5.    (OrbitAnalytics)
+    m_analyticsTitleLabel = tgui::Label::create(L" ");
+    if (!m_analyticsTitleLabel) { std::cerr << "Error: Failed to create m_analyticsTitleLabel" << std::endl; return; }
+    m_analyticsTitleLabel->getRenderer()->setTextStyle(tgui::TextStyle::Bold);
+    m_analyticsTitleLabel->setHorizontalAlignment(tgui::Label::HorizontalAlignment::Center);
+    m_analyticsTitleLabel->getRenderer()->setTextColor(tgui::Color::Black);
+    m_analyticsTitleLabel->setSize({ "100% - " + tgui::String::fromNumber(2 * PANEL_PADDING), TITLE_HEIGHT });
+    m_analyticsTitleLabel->setPosition({ PANEL_PADDING, tgui::bindBottom(m_showVisualizerButton) + WIDGET_SPACING * 1.5f });
+    m_leftPanel->add(m_analyticsTitleLabel);
+
+    m_analyticsLabel = tgui::Label::create();
+    if (!m_analyticsLabel) { std::cerr << "Error: Failed to create m_analyticsLabel" << std::endl; return; }
+    m_analyticsLabel->getRenderer()->setTextColor(tgui::Color::Black);
+    m_analyticsLabel->setSize({ "100% - " + tgui::String::fromNumber(2 * PANEL_PADDING), 120 });
+    m_analyticsLabel->setPosition({ PANEL_PADDING, tgui::bindBottom(m_analyticsTitleLabel) });
+    m_leftPanel->add(m_analyticsLabel);
+    showOrbitAnalytics(nullptr, 0.0, 0.0);
 }
 
 void UserInterface::loadRightPanelWidgets() {
@@ -266,6 +323,7 @@ void UserInterface::onCalculateButtonPressed() {
     const double SECONDS_PER_DAY = 24.0 * 60.0 * 60.0;
 
     SimulationParameters paramsFromUI;
+    showOrbitAnalytics(nullptr, 0.0, 0.0); //        
 
     double M_ui_val_from_editbox = 1.0;
     double m_satellite_ui_kg = 100.0;    //  ,  (  )
@@ -353,6 +411,9 @@ void UserInterface::onCalculateButtonPressed() {
     //  k  F:
     paramsFromUI.DRAG_COEFFICIENT = k_val_input;
     paramsFromUI.THRUST_COEFFICIENT = F_val_input;
+    if (m_precisionComboBox && m_precisionComboBox->getSelectedItemIndex() >= 0) {
+        paramsFromUI.PRECISION = static_cast<Precision>(m_precisionComboBox->getSelectedItemIndex());
+    }
     std::cout << "DEBUG PARAMS: DRAG_COEFF_calc=" << paramsFromUI.DRAG_COEFFICIENT << ", THRUST_COEFF_calc=" << paramsFromUI.THRUST_COEFFICIENT << std::endl;
 
 
@@ -382,10 +443,22 @@ void UserInterface::onCalculateButtonPressed() {
     std::cout << "DEBUG PARAMS: vy_dimless=" << paramsFromUI.initialState.vy << std::endl;
 
     // ---    ( calculator.runSimulation  ..)   ---
-    Calculations calculator;
-    m_calculatedStates = calculator.runSimulation(paramsFromUI);
+    //      ,     :   
+    //    (clear()      ).
+    //        -     .
+    //    T -        .
+    if (m_simulationCache.lookup(paramsFromUI, m_calculatedStates)) {
+        m_simulationSession.adopt(paramsFromUI, m_calculatedStates);
+    }
+    else {
+        m_simulationSession.run(paramsFromUI, m_calculatedStates);
+        m_simulationCache.store(paramsFromUI, m_calculatedStates);
+    }
 
     m_currentTableData.clear();
+    m_calculatedTimeStep = paramsFromUI.DT;
+    m_calculatedParams = paramsFromUI;
+    startUncertaintyPropagation();
     if (!m_calculatedStates.empty()) {
         m_trajectoryAvailable = true;
 
@@ -418,6 +491,42 @@ void UserInterface::onCalculateButtonPressed() {
 
     prepareTrajectoryForDisplay();
     populateTable(m_currentTableData);
+
+    if (m_trajectoryAvailable) {
+        const OrbitAnalytics::Summary summary = m_simulationSession.getAnalytics().getSummary();
+        showOrbitAnalytics(&summary, length_unit, time_unit);
+    }
+}
+
+void UserInterface::showOrbitAnalytics(const OrbitAnalytics::Summary* summary, double lengthUnitMeters, double timeUnitSeconds) {
+    if (!m_analyticsLabel) return;
+    if (!summary || summary->samples == 0) {
+        m_analyticsLabel->setText(L" :  ");
+        return;
+    }
+
+    const double SECONDS_PER_DAY = 24.0 * 60.0 * 60.0;
+    const double kmPerUnit = lengthUnitMeters / 1000.0;
+    const double daysPerUnit = timeUnitSeconds / SECONDS_PER_DAY;
+    std::wostringstream text;
+    text << std::setprecision(5);
+    text << L": " << summary->orbits;
+    if (summary->orbits > 0) {
+        text << L",  " << summary->period * daysPerUnit << L"  (. " << summary->lastPeriod * daysPerUnit << L")";
+    }
+    text << L"\n: " << summary->eccentricityInitial << L" -> " << summary->eccentricityFinal;
+    text << L"\n: ";
+    if (summary->periapsis > 0.0) text << summary->periapsis * kmPerUnit << L" "; else text << L"-";
+    text << L", : ";
+    if (summary->apoapsis > 0.0) text << summary->apoapsis * kmPerUnit << L" "; else text << L"-";
+    text << L"\n :  " << summary->maxRelativeEnergyDrift * 100.0 << L" %";
+    if (!summary->bound) text << L" ( )";
+    text << L"\n  da/dt: " << summary->semiMajorAxisRate * kmPerUnit / daysPerUnit << L" /";
+    //  k = F = 0       ,   4
+    if (KeplerPropagator::isApplicable(m_calculatedParams)) {
+        text << L"\n  (k = F = 0):    ";
+    }
+    m_analyticsLabel->setText(text.str());
 }
 
 
@@ -425,6 +534,8 @@ void UserInterface::onCalculateButtonPressed() {
 
 void UserInterface::prepareTrajectoryForDisplay() {
     m_trajectoryDisplayPoints.clear();
+    m_canvasDirty = true; //     -     render()
+    m_needsRedraw = true;
     if (!m_trajectoryAvailable || m_calculatedStates.empty()) {
         std::cout << "DEBUG: No trajectory to prepare for display." << std::endl;
         return;
@@ -437,6 +548,8 @@ void UserInterface::prepareTrajectoryForDisplay() {
             sf::Color::Blue //   
         );
     }
+    //       ,      
+    m_displayBounds = ScreenProjection::computeBounds(m_trajectoryDisplayPoints.data(), m_trajectoryDisplayPoints.size());
     std::cout << "DEBUG: Trajectory display points prepared. Count: " << m_trajectoryDisplayPoints.size() << std::endl;
 }
 
@@ -448,17 +561,11 @@ void UserInterface::drawTrajectoryOnCanvas(sf::RenderTarget& canvasRenderTarget)
 
         // 1.    (bounding box)   
         //    (  +   (0,0)   )
-        float min_x_content = m_trajectoryDisplayPoints[0].position.x;
-        float max_x_content = m_trajectoryDisplayPoints[0].position.x;
-        float min_y_content = m_trajectoryDisplayPoints[0].position.y; //  <= 0
-        float max_y_content = m_trajectoryDisplayPoints[0].position.y; //  >= min_y_content,   > 0    y_sim=0
-
-        for (const auto& vertex : m_trajectoryDisplayPoints) {
-            min_x_content = std::min(min_x_content, vertex.position.x);
-            max_x_content = std::max(max_x_content, vertex.position.x);
-            min_y_content = std::min(min_y_content, vertex.position.y);
-            max_y_content = std::max(max_y_content, vertex.position.y);
-        }
+        //        prepareTrajectoryForDisplay
+        float min_x_content = m_displayBounds.minX;
+        float max_x_content = m_displayBounds.maxX;
+        float min_y_content = m_displayBounds.minY; //  <= 0
+        float max_y_content = m_displayBounds.maxY; //  >= min_y_content,   > 0    y_sim=0
 
         // ,  (0,0)   bounding box
         min_x_content = std::min(min_x_content, 0.0f);
@@ -546,8 +653,10 @@ void UserInterface::drawTrajectoryOnCanvas(sf::RenderTarget& canvasRenderTarget)
         // ... (  placeholder ) ...
         canvasRenderTarget.setView(canvasRenderTarget.getDefaultView());
         sf::Text placeholderText;
-        if (m_sfmlFont.hasGlyph(L'')) { // ,   
-            placeholderText.setFont(m_sfmlFont);
+        //   SFML         
+        if (!m_sfmlFont) m_sfmlFont = ResourceCache::instance().font("arial.ttf");
+        if (m_sfmlFont && m_sfmlFont->hasGlyph(L'')) { // ,   
+            placeholderText.setFont(*m_sfmlFont);
             placeholderText.setString(L"  .\n ' !'");
         }
         else {
@@ -581,7 +690,8 @@ void UserInterface::onShowVisualizerButtonPressed() {
 
     //  m_calculatedStates (std::vector<State>) 
     //  WorldTrajectoryData (std::vector<std::pair<double, double>>)
-    WorldTrajectoryData trajectoryForVisualizer;
+    WorldTrajectoryData& trajectoryForVisualizer = m_visualizerTrajectory; //    
+    trajectoryForVisualizer.clear();
     trajectoryForVisualizer.reserve(m_calculatedStates.size());
     for (const auto& state : m_calculatedStates) {
         // TrajectoryVisualizer    x, y,
@@ -603,6 +713,15 @@ void UserInterface::onShowVisualizerButtonPressed() {
     try {
         TrajectoryVisualizer visualizer(1000, 800, "Standalone 2D Trajectory Visualizer");
         visualizer.setData(trajectoryForVisualizer);
+        visualizer.setSampleStates(&m_calculatedStates, m_calculatedTimeStep); //    
+        if (m_uncertaintyEnabled) {
+            //  ,     ,    
+            std::unique_lock<std::mutex> lock(m_uncertaintyMutex);
+            m_uncertaintyChanged.wait(lock, [this]() {
+                return m_uncertaintyKey.empty() || m_uncertaintyResultKey == m_uncertaintyKey;
+            });
+            if (!m_uncertaintyKey.empty()) visualizer.setUncertaintyEllipses(m_uncertaintyEllipses);
+        }
         visualizer.run(); //     ,   visualizer  
     }
     catch (const std::exception& e) {
@@ -668,44 +787,149 @@ void UserInterface::populateTable(const std::vector<TableRowData>& data) {
 }
 
 // ---      ---
+void UserInterface::setOnDemandRendering(bool enabled) {
+    m_onDemandRendering = enabled;
+    m_needsRedraw = true;
+}
+
+void UserInterface::setInitialUncertainty(double positionSigma, double velocitySigma) {
+    m_uncertaintyParams.setIndependent(positionSigma, positionSigma, velocitySigma, velocitySigma);
+    m_uncertaintyEnabled = positionSigma > 0.0 || velocitySigma > 0.0;
+    m_uncertaintyKey.clear(); //       
+}
+
+void UserInterface::startUncertaintyPropagation() {
+    if (!m_uncertaintyEnabled) return;
+    SimulationCache::Key key = SimulationCache::makeKey(m_calculatedParams);
+    if (key == m_uncertaintyKey) return; //   ,     
+    m_uncertaintyKey = key;
+
+    //    ,       .
+    //  ,    , ,     .
+    {
+        std::lock_guard<std::mutex> lock(m_uncertaintyMutex);
+        m_uncertaintyRequestParams = m_calculatedParams;
+        m_uncertaintyRequestUncertainty = m_uncertaintyParams;
+        m_uncertaintyRequestKey = std::move(key);
+        m_uncertaintyRequested = true;
+        m_uncertaintyCancel = true;
+    }
+    m_uncertaintyChanged.notify_all();
+    if (!m_uncertaintyWorker.joinable()) {
+        m_uncertaintyWorker = std::thread(&UserInterface::uncertaintyWorkerLoop, this);
+    }
+}
+
+void UserInterface::uncertaintyWorkerLoop() {
+    UncertaintyPropagation propagation;
+    propagation.setCancelFlag(&m_uncertaintyCancel);
+    std::unique_lock<std::mutex> lock(m_uncertaintyMutex);
+    while (true) {
+        m_uncertaintyChanged.wait(lock, [this]() { return m_stopUncertaintyWorker || m_uncertaintyRequested; });
+        if (m_stopUncertaintyWorker) return;
+        const SimulationParameters params = m_uncertaintyRequestParams;
+        const UncertaintyParameters uncertaintyParams = m_uncertaintyRequestUncertainty;
+        SimulationCache::Key key = m_uncertaintyRequestKey;
+        m_uncertaintyRequested = false;
+        m_uncertaintyCancel = false;
+        lock.unlock();
+
+        //  -   -:      
+        //     :     ,   
+        UncertaintyReport report;
+        std::vector<UncertaintyEllipse> ellipses;
+        try {
+            report = propagation.runSimulation(params, uncertaintyParams);
+            for (const UncertaintyEpoch& epoch : report.epochs) {
+                ellipses.push_back(UncertaintyPropagation::positionEllipse(epoch, UNCERTAINTY_ELLIPSE_SIGMAS));
+            }
+        }
+        catch (const std::exception& e) {
+            std::cerr << "UserInterface:    : " << e.what() << std::endl;
+            ellipses.clear();
+        }
+
+        lock.lock();
+        if (!report.cancelled) {
+            m_uncertaintyEllipses.swap(ellipses);
+            m_uncertaintyResultKey = std::move(key);
+            m_uncertaintyChanged.notify_all();
+        }
+    }
+}
+
+void UserInterface::setPrecision(Precision precision) {
+    if (m_precisionComboBox) {
+        m_precisionComboBox->setSelectedItemByIndex(static_cast<std::size_t>(precision));
+    }
+    m_needsRedraw = true;
+}
+
 void UserInterface::run() {
     m_window.setFramerateLimit(60); //  FPS     
     while (m_window.isOpen()) {
         handleEvents();
         update();
-        render();
+        if (m_needsRedraw || !m_onDemandRendering) {
+            render();
+            m_needsRedraw = false;
+        }
     }
 }
 
 void UserInterface::handleEvents() {
     sf::Event event;
-    while (m_window.pollEvent(event)) {
-        // 1.     TGUI    .
-        //    TGUI   sf::Event::Resized   ,
-        //     ,    ,   View.
-        m_gui.handleEvent(event);
-
-        // 2.     
-        if (event.type == sf::Event::Closed) {
-            m_window.close();
+    if (m_onDemandRendering && !m_needsRedraw) {
+        if (!m_gui.getFocusedLeaf()) {
+            //        -     
+            if (m_window.waitEvent(event)) {
+                processEvent(event);
+            }
         }
-        else if (event.type == sf::Event::Resized) {
-            //  SFML  .
-            //  View    SFML.
-            // TGUI,   m_gui.draw(),     View .
-            sf::FloatRect visibleArea(0.f, 0.f, static_cast<float>(event.size.width), static_cast<float>(event.size.height));
-            m_window.setView(sf::View(visibleArea));
-
-            //  :
-            std::cout << "DEBUG: Window Resized to: " << event.size.width << "x" << event.size.height
-                << ". SFML Window View updated." << std::endl;
+        else {
+            //    :      TGUI,  
+            // ,  m_gui.updateTime()   
+            sf::sleep(IDLE_FOCUSED_POLL_INTERVAL);
         }
-        //    
     }
+    while (m_window.pollEvent(event)) {
+        processEvent(event);
+    }
+}
+
+void UserInterface::processEvent(const sf::Event& event) {
+    // 1.     TGUI    .
+    //    TGUI   sf::Event::Resized   ,
+    //     ,    ,   View.
+    m_gui.handleEvent(event);
+
+    //      GUI (, ,  )
+    m_needsRedraw = true;
+
+    // 2.     
+    if (event.type == sf::Event::Closed) {
+        m_window.close();
+    }
+    else if (event.type == sf::Event::Resized) {
+        //  SFML  .
+        //  View    SFML.
+        // TGUI,   m_gui.draw(),     View .
+        sf::FloatRect visibleArea(0.f, 0.f, static_cast<float>(event.size.width), static_cast<float>(event.size.height));
+        m_window.setView(sf::View(visibleArea));
+        m_canvasDirty = true;
+
+        //  :
+        std::cout << "DEBUG: Window Resized to: " << event.size.width << "x" << event.size.height
+            << ". SFML Window View updated." << std::endl;
+    }
+    //    
 }
 
 void UserInterface::update() {
     // ,     ,     
+    if (m_gui.updateTime()) { //  TGUI ( ,  )
+        m_needsRedraw = true;
+    }
 }
 
 void UserInterface::render() {
@@ -728,11 +952,17 @@ void UserInterface::render() {
             else {
                 std::cout << "DEBUG: Canvas widget size is zero, not recreating RenderTexture." << std::endl;
             }
+            m_canvasDirty = true;
         }
 
-        canvasRT.clear(sf::Color(250, 250, 250)); //  
-        drawTrajectoryOnCanvas(canvasRT);      //        View
-        m_trajectoryCanvas->display();
+        //    RenderTexture       ,
+        //         
+        if (m_canvasDirty) {
+            canvasRT.clear(sf::Color(250, 250, 250)); //  
+            drawTrajectoryOnCanvas(canvasRT);      //        View
+            m_trajectoryCanvas->display();
+            m_canvasDirty = false;
+        }
     }
     m_window.clear(sf::Color(220, 220, 220));
     m_gui.draw();
@@ -6,11 +6,19 @@
 #include <SFML/Graphics.hpp>
 #include <TGUI/TGUI.hpp>
 #include "Calculations.h" //  Calculations.h    State
+#include "TrajectoryVisualizer.h" // WorldTrajectoryData
+#include "SimulationCache.h"
+#include "SimulationSession.h"
+#include "UncertaintyPropagation.h"
 
 #include <vector>
 #include <string>
 #include <iomanip>
 #include <sstream>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 struct TableRowData {
     float h_days; //   h_sec  h_days  
@@ -21,8 +29,20 @@ struct TableRowData {
 class UserInterface {
 public:
     UserInterface();
+    ~UserInterface();
     void run();
 
+    //     (  ):   
+    //   ,  TGUI     .
+    void setOnDemandRendering(bool enabled);
+
+    //  ,    "" (,   )
+    void setPrecision(Precision precision);
+
+    //   :   x, y  vx, vy (),
+    //    .  ,     .
+    void setInitialUncertainty(double positionSigma, double velocitySigma);
+
 private:
     static constexpr float INPUT_FIELD_WIDTH = 180.f;
     static constexpr float INPUT_ROW_HEIGHT = 30.f;
@@ -31,6 +51,12 @@ private:
     static constexpr float HEADER_HEIGHT = 30.f;
     static constexpr float TITLE_HEIGHT = 30.f; //     
     static constexpr float SCROLLBAR_WIDTH_ESTIMATE = 18.f;
+    //     ,      (   )
+    const sf::Time IDLE_FOCUSED_POLL_INTERVAL = sf::milliseconds(50);
+    //   : <>.ckpt  <>.states,   N 
+    static constexpr const char* SIMULATION_CHECKPOINT_PATH = "simulation_checkpoint";
+    static constexpr int SIMULATION_CHECKPOINT_INTERVAL_STEPS = 1000000;
+    static constexpr double UNCERTAINTY_ELLIPSE_SIGMAS = 3.0; //    
 
     void initializeGui();
     
@@ -43,6 +69,7 @@ private:
     void setupLayout();
     void connectSignals();
     void handleEvents();
+    void processEvent(const sf::Event& event);
     
     void update();
     void render();
@@ -50,6 +77,10 @@ private:
     void onCalculateButtonPressed();
     void onShowVisualizerButtonPressed(); // <---  
     void populateTable(const std::vector<TableRowData>& data);
+    //  OrbitAnalytics   ; summary == nullptr -  
+    void showOrbitAnalytics(const OrbitAnalytics::Summary* summary, double lengthUnitMeters, double timeUnitSeconds);
+    void startUncertaintyPropagation(); //    m_calculatedParams -   
+    void uncertaintyWorkerLoop();
     
     void drawTrajectoryOnCanvas(sf::RenderTarget& target_rt); //   
     void prepareTrajectoryForDisplay();
@@ -65,9 +96,12 @@ private:
     tgui::EditBox::Ptr m_edit_T;
     tgui::EditBox::Ptr m_edit_k;
     tgui::EditBox::Ptr m_edit_F;
+    tgui::ComboBox::Ptr m_precisionComboBox; //     enum Precision
     tgui::Button::Ptr m_calculateButton;
     tgui::Button::Ptr m_showVisualizerButton; // <---  
     tgui::Grid::Ptr m_inputControlsGrid;
+    tgui::Label::Ptr m_analyticsTitleLabel;
+    tgui::Label::Ptr m_analyticsLabel; // , , , , 
 
     tgui::Panel::Ptr m_leftPanel;
     tgui::Panel::Ptr m_rightPanel;
@@ -76,16 +110,43 @@ private:
 
     tgui::Label::Ptr m_trajectoryTitleLabel;
     tgui::Canvas::Ptr m_trajectoryCanvas;
-    sf::Font m_sfmlFont;
+    std::shared_ptr<const sf::Font> m_sfmlFont; //  ResourceCache    
 
     std::vector<TableRowData> m_currentTableData;
     std::vector<State> m_calculatedStates;
+    double m_calculatedTimeStep; // DT  m_calculatedStates ()
+    SimulationParameters m_calculatedParams; //   m_calculatedStates
+    UncertaintyParameters m_uncertaintyParams;
+    bool m_uncertaintyEnabled;
+    //      ,      .
+    //     :     ,
+    //       .  -     .
+    SimulationCache::Key m_uncertaintyKey; //   (  )
+    std::mutex m_uncertaintyMutex;         //   ,  m_uncertaintyCancel
+    std::condition_variable m_uncertaintyChanged;
+    bool m_uncertaintyRequested;
+    SimulationParameters m_uncertaintyRequestParams;
+    UncertaintyParameters m_uncertaintyRequestUncertainty;
+    SimulationCache::Key m_uncertaintyRequestKey;
+    std::vector<UncertaintyEllipse> m_uncertaintyEllipses;
+    SimulationCache::Key m_uncertaintyResultKey;
+    bool m_stopUncertaintyWorker;
+    std::atomic<bool> m_uncertaintyCancel;
+    std::thread m_uncertaintyWorker; //    
     std::vector<sf::Vertex> m_trajectoryDisplayPoints;
+    PointBounds m_displayBounds; //  m_trajectoryDisplayPoints
+    WorldTrajectoryData m_visualizerTrajectory; //   TrajectoryVisualizer
+    SimulationCache m_simulationCache; //     
+    SimulationSession m_simulationSession; //      T
     bool m_trajectoryAvailable;
 
     // View  ,    
     sf::View m_fittedCanvasView;
 
+    bool m_onDemandRendering;
+    bool m_needsRedraw;  //       
+    bool m_canvasDirty;  //   (RenderTexture) 
+
     tgui::Label::Ptr m_tableTitleLabel;
     tgui::Grid::Ptr m_tableHeaderGrid;
     tgui::ScrollablePanel::Ptr m_tableDataPanel;
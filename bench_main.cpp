@@ -0,0 +1,210 @@
+#include "Calculations.h"
+#include "OrbitAnalytics.h"
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+#include <clocale>
+
+//   :   STEPS     
+//  OrbitAnalytics.   ,     
+// (   -  4).
+//
+//   trajectory_bench [--steps=N] [--repeat=N] [--work-precision=<csv>]
+//
+// --work-precision:    -  " - ".  
+//  (    -  KeplerPropagator,  -
+//  -  4  long double   )   
+//    ,  CSV  ,     
+//       .
+
+namespace {
+template <typename Run>
+double bestMilliseconds(int repeat, Run run) {
+    double best = 0.0;
+    for (int i = 0; i < repeat; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (i == 0 || ms < best) best = ms;
+    }
+    return best;
+}
+
+void report(const std::string& name, double ms, int steps) {
+    std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(1)
+        << std::setw(10) << ms << " " << std::setw(10) << ms * 1e6 / steps << " /\n";
+}
+
+//       (   - SUNDMAN_STEP)
+const double WORK_PRECISION_DURATION = 20.0;
+const double WORK_PRECISION_STEPS[] = { 0.1, 0.05, 0.02, 0.01, 0.005, 0.002, 0.001, 0.0005 };
+//    : DT     
+const double SUNDMAN_SAMPLE_DT = 0.1;
+//      ,    
+const double DRAG_REFERENCE_DT = 0.00005;
+
+struct WorkPrecisionCase {
+    const char* name;
+    SimulationParameters params;
+    bool analyticReference; // true -  KeplerPropagator,  -  4  long double
+};
+
+struct WorkPrecisionMode {
+    const char* name;
+    Precision precision;
+    bool sundman;
+    bool analytic;
+};
+
+int stepsFor(double dt) {
+    return static_cast<int>(std::lround(WORK_PRECISION_DURATION / dt));
+}
+
+double energy(const SimulationParameters& params, const State& s) {
+    return 0.5 * (s.vx * s.vx + s.vy * s.vy) - params.G * params.M / std::sqrt(s.x * s.x + s.y * s.y);
+}
+
+//    i * sampleDt
+void referenceStates(const WorkPrecisionCase& testCase, const std::vector<State>& dragReference, double sampleDt,
+    std::vector<State>& reference) {
+    if (testCase.analyticReference) {
+        SimulationParameters params = testCase.params;
+        params.ANALYTIC_KEPLER = true;
+        params.DT = sampleDt;
+        params.STEPS = stepsFor(sampleDt);
+        Calculations().runSimulation(params, reference);
+        return;
+    }
+    const size_t stride = static_cast<size_t>(std::lround(sampleDt / DRAG_REFERENCE_DT));
+    reference.clear();
+    for (size_t i = 0; i < dragReference.size(); i += stride) reference.push_back(dragReference[i]);
+}
+
+int runWorkPrecision(const std::string& csvPath, int repeat) {
+    std::ofstream csv(csvPath);
+    if (!csv.is_open()) {
+        std::cerr << ":     '" << csvPath << "'  .\n";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<WorkPrecisionCase> cases(3);
+    cases[0].name = "circular";
+    cases[0].params.DRAG_COEFFICIENT = 0.0;
+    cases[0].params.initialState.vy = std::sqrt(1.0 / cases[0].params.initialState.x);
+    cases[0].analyticReference = true;
+    cases[1].name = "eccentric"; // e = 0.62,  0.35
+    cases[1].params.DRAG_COEFFICIENT = 0.0;
+    cases[1].params.initialState.vy = 0.5;
+    cases[1].analyticReference = true;
+    cases[2].name = "drag-decay";
+    cases[2].analyticReference = false;
+
+    const WorkPrecisionMode modes[] = {
+        { "float", Precision::Float, false, false },
+        { "double", Precision::Double, false, false },
+        { "long-double", Precision::LongDouble, false, false },
+        { "kahan", Precision::Compensated, false, false },
+        { "double+sundman", Precision::Double, true, false },
+        { "kepler", Precision::Double, false, true }
+    };
+
+    csv << "case,mode,step,sample_dt,samples,wall_ms,derivative_evaluations,max_position_error,max_energy_error\n";
+    csv << std::setprecision(9);
+    Calculations calculator;
+    std::vector<State> states, reference, dragReference;
+    for (const WorkPrecisionCase& testCase : cases) {
+        if (!testCase.analyticReference) {
+            SimulationParameters params = testCase.params;
+            params.PRECISION = Precision::LongDouble;
+            params.DT = DRAG_REFERENCE_DT;
+            params.STEPS = stepsFor(DRAG_REFERENCE_DT);
+            calculator.runSimulation(params, dragReference);
+        }
+        for (const WorkPrecisionMode& mode : modes) {
+            if (mode.analytic && !testCase.analyticReference) continue; //    
+            for (double step : WORK_PRECISION_STEPS) {
+                SimulationParameters params = testCase.params;
+                params.PRECISION = mode.precision;
+                params.ANALYTIC_KEPLER = mode.analytic;
+                params.DT = mode.sundman ? SUNDMAN_SAMPLE_DT : step;
+                params.SUNDMAN_STEP = mode.sundman ? step : 0.0;
+                params.STEPS = stepsFor(params.DT);
+
+                const double ms = bestMilliseconds(repeat, [&]() { calculator.runSimulation(params, states); });
+                referenceStates(testCase, dragReference, params.DT, reference);
+
+                double positionError = 0.0, energyError = 0.0;
+                const double energyScale = std::abs(energy(params, reference.front()));
+                const size_t common = std::min(states.size(), reference.size());
+                for (size_t i = 0; i < common; ++i) {
+                    positionError = std::max(positionError,
+                        std::hypot(states[i].x - reference[i].x, states[i].y - reference[i].y));
+                    energyError = std::max(energyError,
+                        std::abs(energy(params, states[i]) - energy(params, reference[i])) / energyScale);
+                }
+                if (states.size() != reference.size()) {
+                    std::cerr << testCase.name << "/" << mode.name << "  " << step
+                        << ":      ()\n";
+                }
+                csv << testCase.name << "," << mode.name << "," << step << "," << params.DT << "," << states.size() << ","
+                    << ms << "," << calculator.getDerivativeEvaluations() << "," << positionError << "," << energyError << "\n";
+            }
+            std::cout << testCase.name << " / " << mode.name << " - \n";
+        }
+    }
+    std::cout << "   " << csvPath << "\n";
+    return EXIT_SUCCESS;
+}
+}
+
+int main(int argc, char* argv[]) {
+    setlocale(LC_ALL, "Rus");
+
+    int steps = 2000000;
+    int repeat = 3;
+    std::string workPrecisionPath;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.compare(0, 8, "--steps=") == 0) steps = std::atoi(arg.c_str() + 8);
+        else if (arg.compare(0, 9, "--repeat=") == 0) repeat = std::atoi(arg.c_str() + 9);
+        else if (arg.compare(0, 17, "--work-precision=") == 0) workPrecisionPath = arg.substr(17);
+        else {
+            std::cerr << " : " << arg << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+    if (steps <= 0 || repeat <= 0) {
+        std::cerr << "--steps  --repeat    0\n";
+        return EXIT_FAILURE;
+    }
+
+    if (!workPrecisionPath.empty()) return runWorkPrecision(workPrecisionPath, repeat);
+
+    SimulationParameters params;
+    params.DRAG_COEFFICIENT = 0.0;
+    params.ANALYTIC_KEPLER = false;
+    params.STEPS = steps;
+
+    Calculations calculator;
+    std::vector<State> states;
+    std::cout << "trajectory_bench: " << steps << " ,   " << repeat << " \n";
+
+    const Precision precisions[] = { Precision::Float, Precision::Double, Precision::LongDouble, Precision::Compensated };
+    for (Precision precision : precisions) {
+        params.PRECISION = precision;
+        report(Calculations::precisionName(precision),
+            bestMilliseconds(repeat, [&]() { calculator.runSimulation(params, states); }), steps);
+    }
+
+    params.PRECISION = Precision::Double;
+    OrbitAnalytics analytics;
+    report("double + analytics",
+        bestMilliseconds(repeat, [&]() { calculator.runSimulation(params, states, &analytics); }), steps);
+    return EXIT_SUCCESS;
+}
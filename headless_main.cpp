@@ -0,0 +1,311 @@
+#include "Calculations.h"
+#include "OrbitAnalytics.h"
+#include "ChunkedTrajectoryFile.h"
+#include "TargetingSolver.h"
+#include "AtmosphereModel.h"
+#include "UncertaintyPropagation.h"
+#include "NBodyCalculations.h"
+#include "PararealCalculations.h"
+#include "KeplerPropagator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+#include <clocale>
+
+//   :    ,   -  OrbitAnalytics
+//  ( )       out-of-core .
+//
+//   trajectory_headless [--steps=N] [--dt=X] [--k=X] [--F=X] [--x=X] [--vy=X] [--sundman=X]
+//                       [--precision=float|double|long-double|kahan]
+//                       [--output=<txt>] [--write-dump=<>] [--sensitivity]
+//                       [--atmosphere=< -> --atmosphere-drag=X] [--rk4]
+//
+//  k = F = 0      (KeplerPropagator), --precision
+//  --sundman    ; --rk4   .
+//
+// --sensitivity:       , 
+//    (  )  V0, k  F.
+//
+//   (TargetingSolver)  :
+//   --target-period=X | --target-final-r=X | --target-min-r=X
+//   [--solve-for=V0|F] [--search-min=X] [--search-max=X]
+//     ,     .
+//
+//    (UncertaintyPropagation)   :
+//   --uncertainty-pos=X [--uncertainty-vel=X] [--uncertainty-epochs=N] [--monte-carlo=N]
+// X -   x, y  vx, vy ().  , 
+//     (1 )  ; --monte-carlo=N     N .
+//
+// Parareal (PararealCalculations)   4:
+//   --parareal[=] [--coarse-ratio=N] [--parareal-serial=0|1]
+//  : , , ,    
+//   (--parareal-serial=0  ).   --output -  .
+//
+// N  (NBodyCalculations)   :
+//   --bodies=<> [--record-every=N]
+//     "x y vx vy mass"  ;   (M, ), k, F, dt  steps -
+//    . --output    "t x0 y0 x1 y1 ..." ( 
+//  max(1, steps/1000)- ).
+
+namespace {
+bool readOption(const std::string& arg, const char* name, std::string& value) {
+    const std::string prefix = std::string("--") + name + "=";
+    if (arg.compare(0, prefix.size(), prefix) != 0) return false;
+    value = arg.substr(prefix.size());
+    return true;
+}
+
+void printUncertainty(const UncertaintyReport& report) {
+    std::cout << "          t           x           y     sigma_x     sigma_y    \n";
+    for (const UncertaintyEpoch& epoch : report.epochs) {
+        const UncertaintyEllipse ellipse = UncertaintyPropagation::positionEllipse(epoch, 1.0);
+        std::cout << std::setw(6) << epoch.step << " " << std::setw(8) << epoch.time << " "
+            << std::setw(11) << epoch.mean.x << " " << std::setw(11) << epoch.mean.y << " "
+            << std::setw(11) << std::sqrt(epoch.covariance[0][0]) << " " << std::setw(11) << std::sqrt(epoch.covariance[1][1]) << " "
+            << ellipse.semiMajor << " x " << ellipse.semiMinor << "\n";
+    }
+}
+
+int runBodies(const SimulationParameters& params, const std::string& bodiesPath, int recordEvery,
+    const std::string& outputPath) {
+    BodySystem bodies;
+    if (!NBodyCalculations::loadBodies(bodiesPath, bodies)) return EXIT_FAILURE;
+    if (bodies.size() == 0) {
+        std::cerr << "  " << bodiesPath << "  \n";
+        return EXIT_FAILURE;
+    }
+
+    NBodyParameters nbody;
+    nbody.G = params.G;
+    nbody.CENTRAL_MASS = params.M;
+    nbody.CENTRAL_BODY_RADIUS = params.CENTRAL_BODY_RADIUS;
+    nbody.DRAG_COEFFICIENT = params.DRAG_COEFFICIENT;
+    nbody.THRUST_COEFFICIENT = params.THRUST_COEFFICIENT;
+    nbody.DT = params.DT;
+    nbody.STEPS = params.STEPS;
+    nbody.RECORD_EVERY = recordEvery > 0 ? recordEvery : std::max(1, params.STEPS / 1000);
+
+    const auto startTime = std::chrono::steady_clock::now();
+    NBodyCalculations calculator;
+    const NBodyTrajectory trajectory = calculator.runSimulation(bodies, nbody);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    size_t crashedCount = 0;
+    for (unsigned char crashed : trajectory.crashed) crashedCount += crashed ? 1 : 0;
+    std::cout << ": " << trajectory.bodyCount << ", : " << trajectory.snapshotCount()
+        << ",    : " << crashedCount << ",  : " << seconds << " \n";
+
+    if (!outputPath.empty()) {
+        std::ofstream fout(outputPath);
+        if (!fout.is_open()) {
+            std::cerr << ":     '" << outputPath << "'  .\n";
+            return EXIT_FAILURE;
+        }
+        fout << std::fixed << std::setprecision(10);
+        for (size_t s = 0; s < trajectory.snapshotCount(); ++s) {
+            fout << trajectory.time[s];
+            for (size_t b = 0; b < trajectory.bodyCount; ++b) {
+                const size_t index = s * trajectory.bodyCount + b;
+                fout << " " << trajectory.x[index] << " " << trajectory.y[index];
+            }
+            fout << "\n";
+        }
+        std::cout << "   " << outputPath << "\n";
+    }
+    return EXIT_SUCCESS;
+}
+
+void printParareal(const PararealReport& report, const PararealParameters& pararealParams) {
+    std::cout << "Parareal:  " << report.slices << ",  " << report.iterations
+        << ", : " << (report.converged ? "" : "") << "\n";
+    std::cout << "   Parareal: " << report.pararealSeconds << " \n";
+    if (pararealParams.COMPARE_WITH_SERIAL) {
+        std::cout << "    4: " << report.serialSeconds << " ,  " << report.speedup << "\n";
+        std::cout << "  .  : " << report.maxPositionError << "\n";
+    }
+}
+
+bool writeStates(const std::string& outputPath, const SimulationParameters& params, const std::vector<State>& states) {
+    std::ofstream fout(outputPath);
+    if (!fout.is_open()) {
+        std::cerr << ":     '" << outputPath << "'  .\n";
+        return false;
+    }
+    fout << std::fixed << std::setprecision(10);
+    for (size_t i = 0; i < states.size(); ++i) {
+        fout << i * params.DT << " " << states[i].x << " " << states[i].y << " "
+            << states[i].vx << " " << states[i].vy << "\n";
+    }
+    std::cout << "  (" << states.size() << " )   " << outputPath << "\n";
+    return true;
+}
+
+void printSensitivities(const SimulationParameters& params, const std::vector<State>& states,
+    const StateSensitivity& sensitivity) {
+    const State& last = states.back();
+    const bool collided = last.x * last.x + last.y * last.y < params.CENTRAL_BODY_RADIUS * params.CENTRAL_BODY_RADIUS;
+    double byV0[4], byK[4], byF[4];
+    for (int i = 0; i < 4; ++i) {
+        byV0[i] = sensitivity.stateTransition[i][3];
+        byF[i] = sensitivity.propulsion[i];
+        byK[i] = -sensitivity.propulsion[i];
+    }
+    const char* names[] = { "V0", "k", "F" };
+    const double* columns[] = { byV0, byK, byF };
+    std::cout << "    " << states.size() - 1 << " (x, y, vx, vy):\n";
+    for (int p = 0; p < 3; ++p) {
+        std::cout << "  d/d" << names[p] << ": " << columns[p][0] << " " << columns[p][1] << " "
+            << columns[p][2] << " " << columns[p][3] << "\n";
+    }
+    if (collided) {
+        for (int p = 0; p < 3; ++p) {
+            std::cout << "  d( )/d" << names[p] << ": "
+                << StateSensitivity::radiusCrossingTimeDerivative(last, columns[p]) << "\n";
+        }
+    }
+}
+}
+
+int main(int argc, char* argv[]) {
+    setlocale(LC_ALL, "Rus");
+    setlocale(LC_NUMERIC, "C"); // std::atof     ,    "Rus"
+
+    SimulationParameters params;
+    std::string outputPath, dumpPath, bodiesPath;
+    int recordEvery = 0;
+    bool pararealRequested = false;
+    PararealParameters parareal;
+    bool printSensitivity = false;
+    bool targetingRequested = false;
+    TargetingParameters targeting;
+    double positionSigma = 0.0, velocitySigma = 0.0;
+    UncertaintyParameters uncertainty;
+    targeting.SEARCH_MAX = 2.0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        std::string value;
+        if (readOption(arg, "steps", value)) params.STEPS = std::atoi(value.c_str());
+        else if (readOption(arg, "dt", value)) params.DT = std::atof(value.c_str());
+        else if (readOption(arg, "k", value)) params.DRAG_COEFFICIENT = std::atof(value.c_str());
+        else if (readOption(arg, "F", value)) params.THRUST_COEFFICIENT = std::atof(value.c_str());
+        else if (readOption(arg, "x", value)) params.initialState.x = std::atof(value.c_str());
+        else if (readOption(arg, "vy", value)) params.initialState.vy = std::atof(value.c_str());
+        else if (readOption(arg, "sundman", value)) params.SUNDMAN_STEP = std::atof(value.c_str());
+        else if (readOption(arg, "atmosphere-drag", value)) params.ATMOSPHERE_DRAG = std::atof(value.c_str());
+        else if (readOption(arg, "atmosphere", value)) {
+            params.ATMOSPHERE = AtmosphereModel::loadTable(value);
+            if (!params.ATMOSPHERE) return EXIT_FAILURE;
+        }
+        else if (readOption(arg, "output", value)) outputPath = value;
+        else if (readOption(arg, "write-dump", value)) dumpPath = value;
+        else if (readOption(arg, "bodies", value)) bodiesPath = value;
+        else if (readOption(arg, "record-every", value)) recordEvery = std::atoi(value.c_str());
+        else if (arg == "--sensitivity") printSensitivity = true;
+        else if (arg == "--rk4") params.ANALYTIC_KEPLER = false;
+        else if (arg == "--parareal") pararealRequested = true;
+        else if (readOption(arg, "parareal", value)) {
+            parareal.SLICES = static_cast<unsigned int>(std::max(0, std::atoi(value.c_str())));
+            pararealRequested = true;
+        }
+        else if (readOption(arg, "coarse-ratio", value)) parareal.COARSE_STEP_RATIO = std::atoi(value.c_str());
+        else if (readOption(arg, "parareal-serial", value)) parareal.COMPARE_WITH_SERIAL = std::atoi(value.c_str()) != 0;
+        else if (readOption(arg, "target-period", value) || readOption(arg, "target-final-r", value) ||
+            readOption(arg, "target-min-r", value)) {
+            targeting.GOAL = arg.compare(0, 15, "--target-period") == 0 ? TargetingGoal::Period
+                : arg.compare(0, 16, "--target-final-r") == 0 ? TargetingGoal::FinalRadius : TargetingGoal::MinimumRadius;
+            targeting.TARGET = std::atof(value.c_str());
+            targetingRequested = true;
+        }
+        else if (readOption(arg, "solve-for", value)) {
+            if (value != "V0" && value != "F") {
+                std::cerr << "   '" << value << "' (V0  F)\n";
+                return EXIT_FAILURE;
+            }
+            targeting.VARIABLE = value == "F" ? TargetingVariable::Thrust : TargetingVariable::InitialSpeed;
+        }
+        else if (readOption(arg, "uncertainty-pos", value)) positionSigma = std::atof(value.c_str());
+        else if (readOption(arg, "uncertainty-vel", value)) velocitySigma = std::atof(value.c_str());
+        else if (readOption(arg, "uncertainty-epochs", value)) uncertainty.EPOCH_COUNT = std::atoi(value.c_str());
+        else if (readOption(arg, "monte-carlo", value)) uncertainty.MONTE_CARLO_SAMPLES = std::atoi(value.c_str());
+        else if (readOption(arg, "search-min", value)) targeting.SEARCH_MIN = std::atof(value.c_str());
+        else if (readOption(arg, "search-max", value)) targeting.SEARCH_MAX = std::atof(value.c_str());
+        else if (readOption(arg, "precision", value)) {
+            if (!Calculations::parsePrecision(value, params.PRECISION)) {
+                std::cerr << "  '" << value << "'\n";
+                return EXIT_FAILURE;
+            }
+        }
+        else {
+            std::cerr << " : " << arg << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    //    ( )      -  ,   
+    if (static_cast<bool>(params.ATMOSPHERE) != (params.ATMOSPHERE_DRAG != 0.0)) {
+        std::cerr << "--atmosphere  --atmosphere-drag ( 0)  \n";
+        return EXIT_FAILURE;
+    }
+
+    //  - ,   ,    Calculations:    
+    //         
+    if (!printSensitivity && KeplerPropagator::isApplicable(params) &&
+        (params.PRECISION != Precision::Double || params.SUNDMAN_STEP > 0.0)) {
+        std::cout << "k = F = 0:      , --precision  --sundman   "
+            "(--rk4 -  4)\n";
+    }
+
+    if (targetingRequested) {
+        TargetingSolver solver;
+        const TargetingReport report = solver.solve(params, targeting);
+        if (!report.converged) return EXIT_FAILURE;
+        if (targeting.VARIABLE == TargetingVariable::Thrust) params.THRUST_COEFFICIENT = report.value;
+        else params.initialState.vy = report.value;
+    }
+
+    if (!bodiesPath.empty()) return runBodies(params, bodiesPath, recordEvery, outputPath);
+
+    if (positionSigma > 0.0 || velocitySigma > 0.0) {
+        uncertainty.setIndependent(positionSigma, positionSigma, velocitySigma, velocitySigma);
+        UncertaintyPropagation propagation;
+        const UncertaintyReport report = propagation.runSimulation(params, uncertainty);
+        if (!report.valid) return EXIT_FAILURE;
+        printUncertainty(report);
+        return EXIT_SUCCESS;
+    }
+
+    if (pararealRequested) {
+        PararealCalculations calculator;
+        std::vector<State> states;
+        const PararealReport report = calculator.runSimulation(params, parareal, states);
+        printParareal(report, parareal);
+        OrbitAnalytics analytics;
+        analytics.reset(params);
+        for (const State& state : states) analytics.addState(state);
+        analytics.printSummary(std::cout);
+        if (!outputPath.empty() && !writeStates(outputPath, params, states)) return EXIT_FAILURE;
+        return EXIT_SUCCESS;
+    }
+
+    // Out-of-core   ,     
+    if (!dumpPath.empty()) {
+        return ChunkedTrajectoryWriter::writeSimulation(params, dumpPath) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    Calculations calculator;
+    OrbitAnalytics analytics;
+    std::vector<State> states;
+    StateSensitivity sensitivity;
+    calculator.runSimulation(params, states, &analytics, printSensitivity ? &sensitivity : nullptr);
+    analytics.printSummary(std::cout);
+    if (printSensitivity) printSensitivities(params, states, sensitivity);
+
+    if (!outputPath.empty() && !writeStates(outputPath, params, states)) return EXIT_FAILURE;
+    return EXIT_SUCCESS;
+}
@@ -1,23 +1,132 @@
 ﻿#include "Calculations.h"         // Для расчетов
 #include "TrajectoryVisualizer.h" // Для визуализации
 #include "UserInterface.h"        // Для вашего TGUI интерфейса
+#include "ChunkedTrajectoryFile.h" // Для --write-dump
 
 #include <iostream>
 #include <string>
 #include <stdexcept>   // Для tgui::Exception и std::exception
 #include <iomanip>     // Для std::fixed, std::setprecision в saveTrajectoryToFile
 #include <fstream>     // Для std::ofstream в saveTrajectoryToFile
+#include <cstdlib>     // Для std::atoi
+#include <cstdint>
+#include <limits>
+#include <locale>
+#include <sstream>
 
 void saveTrajectoryToFile(const WorldTrajectoryData& trajectoryData, const std::string& filename);
 
+// Число из командной строки всегда с десятичной точкой: std::atof после setlocale(LC_ALL, "Rus")
+// ждал бы запятую. Поля ввода интерфейса по-прежнему в локали программы.
+double parseArgumentNumber(const std::string& text) {
+    std::istringstream in(text);
+    in.imbue(std::locale::classic());
+    double value = 0.0;
+    if (!(in >> value)) std::cerr << "Не число: '" << text << "', используется 0\n";
+    return value;
+}
+
+// "first:last" - номера точек, любая граница может быть пустой (начало или конец файла)
+bool parseViewWindow(const std::string& text, uint64_t& first, uint64_t& last) {
+    const size_t separator = text.find(':');
+    if (separator == std::string::npos) return false;
+    const std::string bounds[2] = { text.substr(0, separator), text.substr(separator + 1) };
+    uint64_t values[2] = { 0, std::numeric_limits<uint64_t>::max() };
+    for (int i = 0; i < 2; ++i) {
+        if (bounds[i].empty()) continue;
+        std::istringstream in(bounds[i]);
+        in.imbue(std::locale::classic());
+        if (!(in >> values[i]) || in.peek() != std::char_traits<char>::eof()) return false;
+    }
+    first = values[0];
+    last = values[1];
+    return true;
+}
+
 
-int main() {
+int main(int argc, char* argv[]) {
     setlocale(LC_ALL, "Rus");
 
+    // Командная строка: --precision=float|double|long-double|kahan
+    //   --write-dump=<файл> [--steps=N] - расчет с параметрами по умолчанию сразу в файл out-of-core формата
+    //   --view-dump=<файл>              - просмотр такого файла без загрузки в память целиком
+    //   --view-window=first:last        - показать из него только точки first..last (границы можно опускать)
+    //   --uncertainty-pos=X --uncertainty-vel=X - сигмы начального положения и скорости: визуализатор
+    //                                     рисует эллипсы ошибки положения (UncertaintyPropagation)
+    Precision precision = Precision::Double;
+    std::string writeDumpPath, viewDumpPath;
+    int dumpSteps = -1;
+    bool viewWindowSet = false;
+    uint64_t viewFirst = 0, viewLast = 0;
+    double positionSigma = 0.0, velocitySigma = 0.0;
+    const std::string precisionOption = "--precision=";
+    const std::string writeDumpOption = "--write-dump=";
+    const std::string viewDumpOption = "--view-dump=";
+    const std::string viewWindowOption = "--view-window=";
+    const std::string stepsOption = "--steps=";
+    const std::string uncertaintyPosOption = "--uncertainty-pos=";
+    const std::string uncertaintyVelOption = "--uncertainty-vel=";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.compare(0, writeDumpOption.size(), writeDumpOption) == 0) {
+            writeDumpPath = arg.substr(writeDumpOption.size());
+        }
+        else if (arg.compare(0, viewDumpOption.size(), viewDumpOption) == 0) {
+            viewDumpPath = arg.substr(viewDumpOption.size());
+        }
+        else if (arg.compare(0, viewWindowOption.size(), viewWindowOption) == 0) {
+            viewWindowSet = parseViewWindow(arg.substr(viewWindowOption.size()), viewFirst, viewLast);
+            if (!viewWindowSet) {
+                std::cerr << "Неверное окно '" << arg.substr(viewWindowOption.size())
+                    << "' (ожидается first:last), показывается весь файл\n";
+            }
+        }
+        else if (arg.compare(0, stepsOption.size(), stepsOption) == 0) {
+            dumpSteps = std::atoi(arg.c_str() + stepsOption.size());
+        }
+        else if (arg.compare(0, uncertaintyPosOption.size(), uncertaintyPosOption) == 0) {
+            positionSigma = parseArgumentNumber(arg.substr(uncertaintyPosOption.size()));
+        }
+        else if (arg.compare(0, uncertaintyVelOption.size(), uncertaintyVelOption) == 0) {
+            velocitySigma = parseArgumentNumber(arg.substr(uncertaintyVelOption.size()));
+        }
+        else if (arg.compare(0, precisionOption.size(), precisionOption) == 0) {
+            if (!Calculations::parsePrecision(arg.substr(precisionOption.size()), precision)) {
+                std::cerr << "Неизвестная точность '" << arg.substr(precisionOption.size())
+                    << "', используется double\n";
+                precision = Precision::Double;
+            }
+        }
+        else {
+            std::cerr << "Неизвестный аргумент: " << arg << "\n";
+        }
+    }
+
+    if (!writeDumpPath.empty()) {
+        SimulationParameters params;
+        params.PRECISION = precision;
+        if (dumpSteps >= 0) params.STEPS = dumpSteps;
+        return ChunkedTrajectoryWriter::writeSimulation(params, writeDumpPath) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (!viewDumpPath.empty()) {
+        bool opened = false;
+        {
+            TrajectoryVisualizer visualizer(1280, 900, "Trajectory Visualizer - " + viewDumpPath);
+            opened = visualizer.openOutOfCore(viewDumpPath);
+            if (opened && viewWindowSet) visualizer.setOutOfCoreTimeWindow(viewFirst, viewLast);
+            if (opened) visualizer.run();
+        }
+        ResourceCache::instance().clear(); // Окно из пула и шрифт - до выхода из main
+        return opened ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     // 1. ОКНО ПРОГРАММЫ //
 
     try {
         UserInterface uiApp;
+        uiApp.setPrecision(precision);
+        uiApp.setInitialUncertainty(positionSigma, velocitySigma);
         uiApp.run();
     }
     catch (const tgui::Exception& e) {
@@ -37,6 +146,7 @@ int main() {
         return EXIT_FAILURE;
     }
 
+    ResourceCache::instance().clear(); // Окно визуализатора из пула и общие шрифты
     return EXIT_SUCCESS;
 }
 
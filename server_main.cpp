@@ -0,0 +1,44 @@
+#include "SimulationServer.h"
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <clocale>
+
+#if defined(_WIN32)
+#include <fcntl.h>  // _O_BINARY
+#include <io.h>     // _setmode
+#include <cstdio>
+#endif
+
+//     :  -   stdin,  - 
+//   stdout ( -  SimulationServer.h).     stderr.
+//
+//   trajectory_server [--threads=N]
+
+int main(int argc, char* argv[]) {
+    setlocale(LC_ALL, "Rus");
+    setlocale(LC_NUMERIC, "C"); //    ,       
+
+    unsigned int threads = 0;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.compare(0, 10, "--threads=") == 0) threads = static_cast<unsigned int>(std::atoi(arg.c_str() + 10));
+        else {
+            std::cerr << " : " << arg << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+#if defined(_WIN32)
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    // stdout   : ,     std::cout,   stderr
+    std::ostream results(std::cout.rdbuf());
+    std::cout.rdbuf(std::cerr.rdbuf());
+
+    SimulationServer server(threads);
+    const size_t jobs = server.serve(std::cin, results);
+    std::cerr << "SimulationServer:  : " << jobs << "\n";
+    return EXIT_SUCCESS;
+}